@@ -33,6 +33,7 @@
 #include <content/public/browser/browser_thread.h>
 #include <content/public/common/content_switches.h>
 #include <content/public/common/url_constants.h>
+#include <net/base/network_quality_estimator.h>
 #include <net/cert/cert_verifier.h>
 #include <net/cookies/cookie_monster.h>
 #include <net/dns/mapped_host_resolver.h>
@@ -195,6 +196,14 @@ void URLRequestContextGetterImpl::initialize()
 
     d_urlRequestContext.reset(new net::URLRequestContext());
     d_urlRequestContext->set_proxy_service(d_proxyService.get());
+
+    // The estimator observes the requests of this context.  The
+    // ResourceScheduler uses its estimates to size its request limits.
+    d_networkQualityEstimator.reset(new net::NetworkQualityEstimator(
+        scoped_ptr<net::ExternalEstimateProvider>(),
+        std::map<std::string, std::string>()));
+    d_urlRequestContext->set_network_quality_estimator(
+        d_networkQualityEstimator.get());
     d_storage.reset(
         new net::URLRequestContextStorage(d_urlRequestContext.get()));
     d_storage->set_network_delegate(make_scoped_ptr(new NetworkDelegateImpl()));
@@ -268,6 +277,12 @@ void URLRequestContextGetterImpl::initialize()
     net::HttpCache* mainCache = new net::HttpCache(d_storage->http_network_session(),
                                                    backendFactory.Pass(),
                                                    true);
+    if (cmdline.HasSwitch(switches::kEnableHttpCacheStreamingReaders)) {
+        mainCache->set_use_streaming_readers(true);
+    }
+    if (cmdline.HasSwitch(switches::kEnableStaleWhileRevalidate)) {
+        mainCache->set_use_stale_while_revalidate(true);
+    }
     d_storage->set_http_transaction_factory(make_scoped_ptr(mainCache));
 
     scoped_ptr<net::URLRequestJobFactoryImpl> jobFactory(
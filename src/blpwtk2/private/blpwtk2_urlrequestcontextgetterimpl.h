@@ -35,6 +35,7 @@
 #include <net/url_request/url_request_job_factory.h>
 
 namespace net {
+    class NetworkQualityEstimator;
     class ProxyConfig;
     class ProxyConfigService;
     class ProxyService;
@@ -82,6 +83,7 @@ private:
         scoped_ptr<net::ProxyConfigService> proxyConfigService);
 
     scoped_ptr<net::ProxyService> d_proxyService;
+    scoped_ptr<net::NetworkQualityEstimator> d_networkQualityEstimator;
     scoped_refptr<net::CookieMonster::PersistentCookieStore> d_cookieStore;
     scoped_ptr<net::URLRequestContextStorage> d_storage;
     scoped_ptr<net::URLRequestContext> d_urlRequestContext;
@@ -14,12 +14,57 @@ RTree::RTree() : num_data_elements_(0u) {}
 
 RTree::~RTree() {}
 
-RTree::Node* RTree::AllocateNodeAtLevel(int level) {
+size_t RTree::AllocateNodeAtLevel(int level) {
   nodes_.push_back(Node());
   Node& node = nodes_.back();
   node.num_children = 0;
   node.level = level;
-  return &node;
+  return nodes_.size() - 1;
+}
+
+// static
+void RTree::AppendChild(Node* node, const Branch& branch) {
+  DCHECK_LT(node->num_children, MAX_CHILDREN);
+  uint16_t i = node->num_children++;
+  node->left[i] = branch.bounds.x();
+  node->top[i] = branch.bounds.y();
+  node->right[i] = branch.bounds.right();
+  node->bottom[i] = branch.bounds.bottom();
+  node->children[i] = branch.index;
+}
+
+// static
+size_t RTree::NodeCountForElements(size_t num_elements) {
+  if (num_elements == 1)
+    return 1;
+
+  // Each level packs its branches into nodes of up to MAX_CHILDREN children,
+  // see BuildRecursive().
+  size_t num_nodes = 0;
+  while (num_elements > 1) {
+    num_elements = (num_elements + MAX_CHILDREN - 1) / MAX_CHILDREN;
+    num_nodes += num_elements;
+  }
+  return num_nodes;
+}
+
+// static
+void RTree::IntersectChildren(const Node& node,
+                              const gfx::RectF& query,
+                              bool* intersects) {
+  DCHECK(!query.IsEmpty());
+  // Same as gfx::RectF::Intersects(), given that the children are not empty.
+  // Written without branches so that it is vectorized.
+  float query_left = query.x();
+  float query_top = query.y();
+  float query_right = query.right();
+  float query_bottom = query.bottom();
+  for (uint16_t i = 0; i < node.num_children; ++i) {
+    intersects[i] = (node.left[i] < query_right) &
+                    (query_left < node.right[i]) &
+                    (node.top[i] < query_bottom) &
+                    (query_top < node.bottom[i]);
+  }
 }
 
 RTree::Branch RTree::BuildRecursive(std::vector<Branch>* branches, int level) {
@@ -65,19 +110,17 @@ RTree::Branch RTree::BuildRecursive(std::vector<Branch>* branches, int level) {
           remainder -= MAX_CHILDREN - MIN_CHILDREN;
         }
       }
-      Node* node = AllocateNodeAtLevel(level);
-      node->num_children = 1;
-      node->children[0] = (*branches)[current_branch];
-
       Branch branch;
+      branch.index = AllocateNodeAtLevel(level);
+      Node* node = &nodes_[branch.index];
+      AppendChild(node, (*branches)[current_branch]);
+
       branch.bounds = (*branches)[current_branch].bounds;
-      branch.subtree = node;
       ++current_branch;
       for (int k = 1; k < increment_by && current_branch < branches->size();
            ++k) {
         branch.bounds.Union((*branches)[current_branch].bounds);
-        node->children[k] = (*branches)[current_branch];
-        ++node->num_children;
+        AppendChild(node, (*branches)[current_branch]);
         ++current_branch;
       }
       DCHECK_LT(new_branch_index, current_branch);
@@ -91,21 +134,8 @@ RTree::Branch RTree::BuildRecursive(std::vector<Branch>* branches, int level) {
 
 void RTree::Search(const gfx::RectF& query,
                    std::vector<size_t>* results) const {
-  if (num_data_elements_ > 0 && query.Intersects(root_.bounds))
-    SearchRecursive(root_.subtree, query, results);
-}
-
-void RTree::SearchRecursive(Node* node,
-                            const gfx::RectF& query,
-                            std::vector<size_t>* results) const {
-  for (uint16_t i = 0; i < node->num_children; ++i) {
-    if (query.Intersects(node->children[i].bounds)) {
-      if (node->level == 0)
-        results->push_back(node->children[i].index);
-      else
-        SearchRecursive(node->children[i].subtree, query, results);
-    }
-  }
+  ForEachIntersecting(query,
+                      [results](size_t index) { results->push_back(index); });
 }
 
 }  // namespace cc
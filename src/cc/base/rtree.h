@@ -5,9 +5,11 @@
 #ifndef CC_BASE_RTREE_H_
 #define CC_BASE_RTREE_H_
 
-#include <deque>
+#include <stdint.h>
+
 #include <vector>
 
+#include "base/logging.h"
 #include "cc/base/cc_export.h"
 #include "ui/gfx/geometry/rect_f.h"
 
@@ -28,6 +30,11 @@ namespace cc {
 // probably worth a look). There also exist top-down bulk load variants
 // (VAMSplit, TopDownGreedy, etc).
 //
+// The tree is packed: nodes are stored contiguously and refer to each other by
+// index, and the bounds of the children of a node are stored edge by edge so
+// that they can be tested against a query in a single pass that the compiler
+// can vectorize.
+//
 // For more details see:
 //
 //  Beckmann, N.; Kriegel, H. P.; Schneider, R.; Seeger, B. (1990).
@@ -57,11 +64,11 @@ class CC_EXPORT RTree {
     }
 
     num_data_elements_ = branches.size();
+    nodes_.reserve(NodeCountForElements(num_data_elements_));
     if (num_data_elements_ == 1u) {
-      Node* node = AllocateNodeAtLevel(0);
-      node->num_children = 1;
-      node->children[0] = branches[0];
-      root_.subtree = node;
+      size_t node_index = AllocateNodeAtLevel(0);
+      AppendChild(&nodes_[node_index], branches[0]);
+      root_.index = node_index;
       root_.bounds = branches[0].bounds;
     } else if (num_data_elements_ > 1u) {
       root_ = BuildRecursive(&branches, 0);
@@ -75,42 +82,79 @@ class CC_EXPORT RTree {
 
   void Search(const gfx::RectF& query, std::vector<size_t>* results) const;
 
+  // Calls |visitor| with the index of each element whose bounds intersect
+  // |query|, in the same order as Search(). Unlike Search(), this never
+  // allocates.
+  template <typename Visitor>
+  void ForEachIntersecting(const gfx::RectF& query,
+                           const Visitor& visitor) const {
+    if (num_data_elements_ > 0 && query.Intersects(root_.bounds))
+      ForEachIntersectingRecursive(root_.index, query, visitor);
+  }
+
  private:
   // These values were empirically determined to produce reasonable performance
   // in most cases.
   enum { MIN_CHILDREN = 6, MAX_CHILDREN = 11 };
 
-  struct Node;
   struct Branch {
     // When the node level is 0, then the node is a leaf and the branch has a
     // valid index pointing to an element in the vector that was used to build
-    // this rtree. When the level is not 0, it's an internal node and it has a
-    // valid subtree pointer.
-    union {
-      Node* subtree;
-      size_t index;
-    };
+    // this rtree. When the level is not 0, it's an internal node and the index
+    // points to its subtree in |nodes_|.
+    size_t index;
     gfx::RectF bounds;
   };
 
   struct Node {
     uint16_t num_children;
     uint16_t level;
-    Branch children[MAX_CHILDREN];
+    // Bounds of the children.
+    float left[MAX_CHILDREN];
+    float top[MAX_CHILDREN];
+    float right[MAX_CHILDREN];
+    float bottom[MAX_CHILDREN];
+    // Indices of the children, see Branch::index.
+    size_t children[MAX_CHILDREN];
   };
 
-  void SearchRecursive(Node* root,
-                       const gfx::RectF& query,
-                       std::vector<size_t>* results) const;
+  template <typename Visitor>
+  void ForEachIntersectingRecursive(size_t node_index,
+                                    const gfx::RectF& query,
+                                    const Visitor& visitor) const {
+    const Node& node = nodes_[node_index];
+    bool intersects[MAX_CHILDREN];
+    IntersectChildren(node, query, intersects);
+    for (uint16_t i = 0; i < node.num_children; ++i) {
+      if (!intersects[i])
+        continue;
+      if (node.level == 0)
+        visitor(node.children[i]);
+      else
+        ForEachIntersectingRecursive(node.children[i], query, visitor);
+    }
+  }
+
+  // Sets |intersects[i]| to whether the i-th child of |node| intersects
+  // |query|, which must not be empty.
+  static void IntersectChildren(const Node& node,
+                                const gfx::RectF& query,
+                                bool* intersects);
+
+  static void AppendChild(Node* node, const Branch& branch);
+
+  // Returns the number of nodes BuildRecursive() allocates for
+  // |num_elements| elements.
+  static size_t NodeCountForElements(size_t num_elements);
 
   // Consumes the input array.
   Branch BuildRecursive(std::vector<Branch>* branches, int level);
-  Node* AllocateNodeAtLevel(int level);
+  size_t AllocateNodeAtLevel(int level);
 
   // This is the count of data elements (rather than total nodes in the tree)
   size_t num_data_elements_;
   Branch root_;
-  std::deque<Node> nodes_;
+  std::vector<Node> nodes_;
 };
 
 }  // namespace cc
@@ -117,6 +117,8 @@
         'debug/devtools_instrumentation.h',
         'debug/frame_rate_counter.cc',
         'debug/frame_rate_counter.h',
+        'debug/frame_stage_timings_benchmark.cc',
+        'debug/frame_stage_timings_benchmark.h',
         'debug/frame_timing_request.cc',
         'debug/frame_timing_request.h',
         'debug/frame_timing_tracker.cc',
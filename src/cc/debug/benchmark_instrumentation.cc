@@ -31,5 +31,17 @@ void IssueDisplayRenderingStatsEvent() {
       scoped_refptr<base::trace_event::ConvertableToTraceFormat>(record_data));
 }
 
+void IssueFrameStageTimingsEvent(const FrameStageTimings& timings) {
+  scoped_refptr<base::trace_event::TracedValue> record_data =
+      new base::trace_event::TracedValue();
+  timings.AsValueInto(record_data.get());
+  TRACE_EVENT_INSTANT1(
+      "benchmark",
+      "BenchmarkInstrumentation::FrameStageTimings",
+      TRACE_EVENT_SCOPE_THREAD,
+      "data",
+      scoped_refptr<base::trace_event::ConvertableToTraceFormat>(record_data));
+}
+
 }  // namespace benchmark_instrumentation
 }  // namespace cc
@@ -44,6 +44,7 @@ class ScopedBeginFrameTask {
 
 void IssueImplThreadRenderingStatsEvent(const RenderingStats& stats);
 void CC_EXPORT IssueDisplayRenderingStatsEvent();
+void IssueFrameStageTimingsEvent(const FrameStageTimings& timings);
 
 }  // namespace benchmark_instrumentation
 }  // namespace cc
@@ -0,0 +1,55 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "cc/debug/frame_stage_timings_benchmark.h"
+
+#include <vector>
+
+#include "base/trace_event/trace_event_argument.h"
+#include "base/values.h"
+#include "cc/debug/rendering_stats_instrumentation.h"
+#include "cc/trees/layer_tree_host.h"
+
+namespace cc {
+
+FrameStageTimingsBenchmark::FrameStageTimingsBenchmark(
+    scoped_ptr<base::Value> value,
+    const MicroBenchmark::DoneCallback& callback)
+    : MicroBenchmark(callback), frame_count_(-1) {
+  if (!value)
+    return;
+
+  base::DictionaryValue* settings = nullptr;
+  value->GetAsDictionary(&settings);
+  if (!settings)
+    return;
+
+  if (settings->HasKey("frame_count"))
+    settings->GetInteger("frame_count", &frame_count_);
+}
+
+FrameStageTimingsBenchmark::~FrameStageTimingsBenchmark() {
+}
+
+void FrameStageTimingsBenchmark::DidUpdateLayers(LayerTreeHost* host) {
+  std::vector<FrameStageTimings> timings =
+      host->rendering_stats_instrumentation()->GetFrameStageTimings();
+  size_t first = 0;
+  if (frame_count_ >= 0 && timings.size() > static_cast<size_t>(frame_count_))
+    first = timings.size() - frame_count_;
+
+  scoped_refptr<base::trace_event::TracedValue> frames =
+      new base::trace_event::TracedValue();
+  frames->BeginArray("frames");
+  for (size_t i = first; i < timings.size(); ++i) {
+    frames->BeginDictionary();
+    timings[i].AsValueInto(frames.get());
+    frames->EndDictionary();
+  }
+  frames->EndArray();
+
+  NotifyDone(frames->ToBaseValue());
+}
+
+}  // namespace cc
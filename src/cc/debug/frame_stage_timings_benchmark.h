@@ -0,0 +1,30 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CC_DEBUG_FRAME_STAGE_TIMINGS_BENCHMARK_H_
+#define CC_DEBUG_FRAME_STAGE_TIMINGS_BENCHMARK_H_
+
+#include "cc/debug/micro_benchmark.h"
+
+namespace cc {
+
+// Returns the per-stage timings of the most recently drawn frames, as kept by
+// RenderingStatsInstrumentation, oldest first. An optional "frame_count"
+// setting limits the result to that many frames.
+class CC_EXPORT FrameStageTimingsBenchmark : public MicroBenchmark {
+ public:
+  FrameStageTimingsBenchmark(scoped_ptr<base::Value> value,
+                             const MicroBenchmark::DoneCallback& callback);
+  ~FrameStageTimingsBenchmark() override;
+
+  // Implements MicroBenchmark interface.
+  void DidUpdateLayers(LayerTreeHost* host) override;
+
+ private:
+  int frame_count_;
+};
+
+}  // namespace cc
+
+#endif  // CC_DEBUG_FRAME_STAGE_TIMINGS_BENCHMARK_H_
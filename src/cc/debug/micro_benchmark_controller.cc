@@ -10,6 +10,7 @@
 #include "base/callback.h"
 #include "base/thread_task_runner_handle.h"
 #include "base/values.h"
+#include "cc/debug/frame_stage_timings_benchmark.h"
 #include "cc/debug/invalidation_benchmark.h"
 #include "cc/debug/rasterize_and_record_benchmark.h"
 #include "cc/debug/unittest_only_benchmark.h"
@@ -26,7 +27,10 @@ scoped_ptr<MicroBenchmark> CreateBenchmark(
     const std::string& name,
     scoped_ptr<base::Value> value,
     const MicroBenchmark::DoneCallback& callback) {
-  if (name == "invalidation_benchmark") {
+  if (name == "frame_stage_timings_benchmark") {
+    return make_scoped_ptr(
+        new FrameStageTimingsBenchmark(value.Pass(), callback));
+  } else if (name == "invalidation_benchmark") {
     return make_scoped_ptr(new InvalidationBenchmark(value.Pass(), callback));
   } else if (name == "rasterize_and_record_benchmark") {
     return make_scoped_ptr(
@@ -40,7 +40,9 @@ RenderingStats::RenderingStats()
       approximated_visible_content_area(0),
       checkerboarded_visible_content_area(0),
       checkerboarded_no_recording_content_area(0),
-      checkerboarded_needs_raster_content_area(0) {}
+      checkerboarded_needs_raster_content_area(0),
+      scrolling_visible_content_area(0),
+      checkerboarded_scrolling_content_area(0) {}
 
 RenderingStats::~RenderingStats() {
 }
@@ -59,6 +61,10 @@ RenderingStats::AsTraceableData() const {
                           checkerboarded_no_recording_content_area);
   record_data->SetInteger("checkerboarded_needs_raster_content_area",
                           checkerboarded_needs_raster_content_area);
+  record_data->SetInteger("scrolling_visible_content_area",
+                          scrolling_visible_content_area);
+  record_data->SetInteger("checkerboarded_scrolling_content_area",
+                          checkerboarded_scrolling_content_area);
   draw_duration.AddToTracedValue("draw_duration_ms", record_data.get());
 
   draw_duration_estimate.AddToTracedValue("draw_duration_estimate_ms",
@@ -88,6 +94,9 @@ void RenderingStats::Add(const RenderingStats& other) {
       other.checkerboarded_no_recording_content_area;
   checkerboarded_needs_raster_content_area +=
       other.checkerboarded_needs_raster_content_area;
+  scrolling_visible_content_area += other.scrolling_visible_content_area;
+  checkerboarded_scrolling_content_area +=
+      other.checkerboarded_scrolling_content_area;
 
   draw_duration.Add(other.draw_duration);
   draw_duration_estimate.Add(other.draw_duration_estimate);
@@ -100,4 +109,21 @@ void RenderingStats::Add(const RenderingStats& other) {
       other.commit_to_activate_duration_estimate);
 }
 
+FrameStageTimings::FrameStageTimings() : has_main_frame(false) {}
+
+void FrameStageTimings::AsValueInto(
+    base::trace_event::TracedValue* value) const {
+  value->SetDouble("frame_time_us",
+                   (frame_time - base::TimeTicks()).InMicroseconds());
+  value->SetBoolean("has_main_frame", has_main_frame);
+  value->SetDouble("input_to_begin_frame_ms",
+                   input_to_begin_frame.InMillisecondsF());
+  value->SetDouble("main_thread_ms", main_thread.InMillisecondsF());
+  value->SetDouble("commit_ms", commit.InMillisecondsF());
+  value->SetDouble("raster_ms", raster.InMillisecondsF());
+  value->SetDouble("activation_ms", activation.InMillisecondsF());
+  value->SetDouble("draw_ms", draw.InMillisecondsF());
+  value->SetDouble("swap_ms", swap.InMillisecondsF());
+}
+
 }  // namespace cc
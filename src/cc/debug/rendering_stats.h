@@ -47,6 +47,10 @@ struct CC_EXPORT RenderingStats {
   int64 checkerboarded_visible_content_area;
   int64 checkerboarded_no_recording_content_area;
   int64 checkerboarded_needs_raster_content_area;
+  // The visible and checkerboarded areas of frames drawn while a scroll or
+  // fling is in progress.
+  int64 scrolling_visible_content_area;
+  int64 checkerboarded_scrolling_content_area;
 
   TimeDeltaList draw_duration;
   TimeDeltaList draw_duration_estimate;
@@ -60,6 +64,32 @@ struct CC_EXPORT RenderingStats {
   void Add(const RenderingStats& other);
 };
 
+// The latency of each pipeline stage that contributed to one drawn compositor
+// frame. The main thread stages belong to the main frame whose tree was
+// activated since the previous draw, and are zero if there was none.
+struct CC_EXPORT FrameStageTimings {
+  FrameStageTimings();
+
+  void AsValueInto(base::trace_event::TracedValue* value) const;
+
+  // The frame time of the BeginImplFrame that drew the frame.
+  base::TimeTicks frame_time;
+  bool has_main_frame;
+
+  // From the first input event handled on the impl thread since the previous
+  // BeginImplFrame, to this frame's BeginImplFrame.
+  base::TimeDelta input_to_begin_frame;
+  // From sending BeginMainFrame to the start of the commit.
+  base::TimeDelta main_thread;
+  base::TimeDelta commit;
+  // From the end of the commit to the pending tree being ready to activate.
+  base::TimeDelta raster;
+  base::TimeDelta activation;
+  base::TimeDelta draw;
+  // From issuing the swap to its completion, or zero if nothing was swapped.
+  base::TimeDelta swap;
+};
+
 }  // namespace cc
 
 #endif  // CC_DEBUG_RENDERING_STATS_H_
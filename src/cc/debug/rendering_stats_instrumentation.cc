@@ -89,6 +89,24 @@ void RenderingStatsInstrumentation::AddCheckerboardedNeedsRasterContentArea(
   impl_thread_rendering_stats_.checkerboarded_needs_raster_content_area += area;
 }
 
+void RenderingStatsInstrumentation::AddScrollingVisibleContentArea(
+    int64 area) {
+  if (!record_rendering_stats_)
+    return;
+
+  base::AutoLock scoped_lock(lock_);
+  impl_thread_rendering_stats_.scrolling_visible_content_area += area;
+}
+
+void RenderingStatsInstrumentation::AddCheckerboardedScrollingContentArea(
+    int64 area) {
+  if (!record_rendering_stats_)
+    return;
+
+  base::AutoLock scoped_lock(lock_);
+  impl_thread_rendering_stats_.checkerboarded_scrolling_content_area += area;
+}
+
 void RenderingStatsInstrumentation::AddDrawDuration(
     base::TimeDelta draw_duration,
     base::TimeDelta draw_duration_estimate) {
@@ -127,4 +145,32 @@ void RenderingStatsInstrumentation::AddCommitToActivateDuration(
       commit_to_activate_duration_estimate);
 }
 
+void RenderingStatsInstrumentation::DidHandleInputEvent(base::TimeTicks time) {
+  base::AutoLock scoped_lock(lock_);
+  if (first_pending_input_time_.is_null())
+    first_pending_input_time_ = time;
+}
+
+base::TimeTicks RenderingStatsInstrumentation::TakeFirstPendingInputTime() {
+  base::AutoLock scoped_lock(lock_);
+  base::TimeTicks time = first_pending_input_time_;
+  first_pending_input_time_ = base::TimeTicks();
+  return time;
+}
+
+void RenderingStatsInstrumentation::AddFrameStageTimings(
+    const FrameStageTimings& timings) {
+  base::AutoLock scoped_lock(lock_);
+  frame_stage_timings_.SaveToBuffer(timings);
+}
+
+std::vector<FrameStageTimings>
+RenderingStatsInstrumentation::GetFrameStageTimings() {
+  base::AutoLock scoped_lock(lock_);
+  std::vector<FrameStageTimings> timings;
+  for (auto it = frame_stage_timings_.Begin(); it; ++it)
+    timings.push_back(**it);
+  return timings;
+}
+
 }  // namespace cc
@@ -5,9 +5,12 @@
 #ifndef CC_DEBUG_RENDERING_STATS_INSTRUMENTATION_H_
 #define CC_DEBUG_RENDERING_STATS_INSTRUMENTATION_H_
 
+#include <vector>
+
 #include "base/memory/scoped_ptr.h"
 #include "base/synchronization/lock.h"
 #include "cc/debug/rendering_stats.h"
+#include "cc/debug/ring_buffer.h"
 
 namespace cc {
 
@@ -43,6 +46,8 @@ class CC_EXPORT RenderingStatsInstrumentation {
   void AddCheckerboardedVisibleContentArea(int64 area);
   void AddCheckerboardedNoRecordingContentArea(int64 area);
   void AddCheckerboardedNeedsRasterContentArea(int64 area);
+  void AddScrollingVisibleContentArea(int64 area);
+  void AddCheckerboardedScrollingContentArea(int64 area);
   void AddDrawDuration(base::TimeDelta draw_duration,
                        base::TimeDelta draw_duration_estimate);
   void AddBeginMainFrameToCommitDuration(
@@ -52,6 +57,17 @@ class CC_EXPORT RenderingStatsInstrumentation {
       base::TimeDelta commit_to_activate_duration,
       base::TimeDelta commit_to_activate_duration_estimate);
 
+  // Notes an input event handled on the impl thread at |time|. Only the
+  // earliest one since the last TakeFirstPendingInputTime() is kept.
+  void DidHandleInputEvent(base::TimeTicks time);
+  base::TimeTicks TakeFirstPendingInputTime();
+
+  // Unlike the stats above, frame stage timings are always recorded, so that
+  // the most recent frames of any session can be queried.
+  void AddFrameStageTimings(const FrameStageTimings& timings);
+  // Returns the recorded frame stage timings, oldest first.
+  std::vector<FrameStageTimings> GetFrameStageTimings();
+
  protected:
   RenderingStatsInstrumentation();
 
@@ -61,6 +77,9 @@ class CC_EXPORT RenderingStatsInstrumentation {
 
   bool record_rendering_stats_;
 
+  base::TimeTicks first_pending_input_time_;
+  RingBuffer<FrameStageTimings, 300> frame_stage_timings_;
+
   base::Lock lock_;
 
   DISALLOW_COPY_AND_ASSIGN(RenderingStatsInstrumentation);
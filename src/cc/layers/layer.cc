@@ -1600,6 +1600,8 @@ void Layer::OnTransformIsPotentiallyAnimatingChanged(bool is_animating) {
       node->data.local_starting_animation_scale = 0.f;
       node->data.has_only_translation_animations = true;
     }
+    // The animation properties of the node are derived from these.
+    node->data.needs_local_transform_update = true;
     transform_tree.set_needs_update(true);
   }
 }
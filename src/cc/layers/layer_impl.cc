@@ -878,6 +878,8 @@ void LayerImpl::UpdatePropertyTreeTransformIsAnimated(bool is_animated) {
         node->data.has_only_translation_animations = true;
       }
 
+      // The animation properties of the node are derived from these.
+      node->data.needs_local_transform_update = true;
       transform_tree.set_needs_update(true);
     }
   }
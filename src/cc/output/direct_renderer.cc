@@ -160,6 +160,7 @@ void DirectRenderer::DecideRenderPassAllocationsForFrame(
         render_passes_in_frame.find(pass_iter->first);
     if (it == render_passes_in_frame.end()) {
       passes_to_delete.push_back(pass_iter->first);
+      cached_render_passes_.erase(pass_iter->first);
       continue;
     }
 
@@ -169,8 +170,10 @@ void DirectRenderer::DecideRenderPassAllocationsForFrame(
 
     bool size_appropriate = texture->size().width() >= required_size.width() &&
                             texture->size().height() >= required_size.height();
-    if (texture->id() && !size_appropriate)
+    if (texture->id() && !size_appropriate) {
       texture->Free();
+      cached_render_passes_.erase(pass_iter->first);
+    }
   }
 
   // Delete RenderPass textures from the previous frame that will not be used
@@ -265,6 +268,12 @@ void DirectRenderer::DrawFrame(RenderPassList* render_passes_in_draw_order,
 
   for (size_t i = 0; i < render_passes_in_draw_order->size(); ++i) {
     RenderPass* pass = render_passes_in_draw_order->at(i);
+    if (pass->use_cached_contents) {
+      // The contents cached for the pass are still in its texture.
+      DCHECK(HasCachedRenderPass(pass->id));
+      DCHECK(pass->copy_requests.empty());
+      continue;
+    }
     DrawRenderPass(&frame, pass);
 
     for (ScopedPtrVector<CopyOutputRequest>::iterator it =
@@ -289,7 +298,8 @@ gfx::Rect DirectRenderer::ComputeScissorRectForRenderPass(
   gfx::Rect render_pass_scissor = frame->current_render_pass->output_rect;
 
   if (frame->root_damage_rect == frame->root_render_pass->output_rect ||
-      !frame->current_render_pass->copy_requests.empty())
+      !frame->current_render_pass->copy_requests.empty() ||
+      frame->current_render_pass->cache_contents)
     return render_pass_scissor;
 
   gfx::Transform inverse_transform(gfx::Transform::kSkipInitialization);
@@ -425,6 +435,11 @@ void DirectRenderer::DrawRenderPass(DrawingFrame* frame,
   if (!UseRenderPass(frame, render_pass))
     return;
 
+  if (render_pass->cache_contents)
+    cached_render_passes_.insert(render_pass->id);
+  else
+    cached_render_passes_.erase(render_pass->id);
+
   const gfx::Rect surface_rect_in_draw_space =
       OutputSurfaceRectInDrawSpace(frame);
   gfx::Rect render_pass_scissor_in_draw_space = surface_rect_in_draw_space;
@@ -557,6 +572,13 @@ bool DirectRenderer::HasAllocatedResourcesForTesting(RenderPassId id) const {
   return texture && texture->id();
 }
 
+bool DirectRenderer::HasCachedRenderPass(RenderPassId id) const {
+  if (!cached_render_passes_.count(id))
+    return false;
+  ScopedResource* texture = render_pass_textures_.get(id);
+  return texture && texture->id();
+}
+
 // static
 gfx::Size DirectRenderer::RenderPassTextureSize(const RenderPass* render_pass) {
   return render_pass->output_rect.size();
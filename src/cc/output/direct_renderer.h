@@ -7,6 +7,7 @@
 
 #include "base/basictypes.h"
 #include "base/callback.h"
+#include "base/containers/hash_tables.h"
 #include "base/containers/scoped_ptr_hash_map.h"
 #include "cc/base/cc_export.h"
 #include "cc/base/scoped_ptr_deque.h"
@@ -32,6 +33,10 @@ class CC_EXPORT DirectRenderer : public Renderer {
   void DecideRenderPassAllocationsForFrame(
       const RenderPassList& render_passes_in_draw_order) override;
   bool HasAllocatedResourcesForTesting(RenderPassId id) const override;
+  // Returns true if the contents drawn for the pass |id| with
+  // RenderPass::cache_contents are still kept, so that a later frame can use
+  // them with RenderPass::use_cached_contents.
+  bool HasCachedRenderPass(RenderPassId id) const;
   void DrawFrame(RenderPassList* render_passes_in_draw_order,
                  float device_scale_factor,
                  const gfx::Rect& device_viewport_rect,
@@ -158,6 +163,9 @@ class CC_EXPORT DirectRenderer : public Renderer {
 
  private:
   gfx::Vector2d enlarge_pass_texture_amount_;
+  // The passes in |render_pass_textures_| whose contents were drawn in full
+  // with RenderPass::cache_contents.
+  base::hash_set<RenderPassId> cached_render_passes_;
 
   DISALLOW_COPY_AND_ASSIGN(DirectRenderer);
 };
@@ -27,6 +27,9 @@ class CC_EXPORT RendererSettings {
   bool use_rgba_4444_textures;
   size_t texture_id_allocation_chunk_size;
   bool use_gpu_memory_buffer_resources;
+  // The number of bands the software compositor splits the root render pass
+  // into to draw it in parallel. 1 draws it on the compositor thread only.
+  int software_compositor_band_count;
 };
 
 }  // namespace cc
@@ -4,6 +4,12 @@
 
 #include "cc/output/software_renderer.h"
 
+#include <algorithm>
+
+#include "base/atomicops.h"
+#include "base/bind.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
 #include "base/trace_event/trace_event.h"
 #include "cc/base/math_util.h"
 #include "cc/output/compositor_frame.h"
@@ -49,8 +55,105 @@ bool IsScaleAndIntegerTranslate(const SkMatrix& matrix) {
          SkScalarNearlyZero(matrix[SkMatrix::kMPersp2] - 1.0f);
 }
 
+// Bands are never shorter than this, so that the per-band overhead of walking
+// the quad list stays small compared to the pixels drawn.
+const int kMinBandHeight = 64;
+
+class DrawBandsTask : public Task {
+ public:
+  explicit DrawBandsTask(const base::Closure& callback)
+      : callback_(callback) {}
+
+  // Overridden from Task:
+  void RunOnWorkerThread() override {
+    TRACE_EVENT0("cc", "DrawBandsTask::RunOnWorkerThread");
+    callback_.Run();
+  }
+
+ protected:
+  ~DrawBandsTask() override {}
+
+ private:
+  const base::Closure callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(DrawBandsTask);
+};
+
 }  // anonymous namespace
 
+// Hands out the bands of a frame to the threads drawing them. The compositor
+// thread draws bands too and then waits for the ones taken by workers, so a
+// frame never waits for a worker that hasn't started. Band tasks that run
+// after all bands were taken return without touching the renderer, which is
+// why this is reference counted rather than owned by the renderer.
+class SoftwareRenderer::BandDrawer
+    : public base::RefCountedThreadSafe<BandDrawer> {
+ public:
+  BandDrawer(SoftwareRenderer* renderer,
+             const DrawingFrame* frame,
+             const std::vector<gfx::Rect>& bands,
+             const SkImageInfo& info,
+             void* pixels,
+             size_t row_bytes)
+      : renderer_(renderer),
+        frame_(frame),
+        bands_(bands),
+        info_(info),
+        pixels_(pixels),
+        row_bytes_(row_bytes),
+        next_band_(0),
+        bands_finished_(0),
+        bands_finished_cv_(&lock_) {}
+
+  // Draws bands until there are none left to take.
+  void DrawBands() {
+    int band_count = static_cast<int>(bands_.size());
+    for (;;) {
+      int band = base::subtle::NoBarrier_AtomicIncrement(&next_band_, 1) - 1;
+      if (band >= band_count)
+        return;
+
+      // Each band draws through its own canvas over the shared pixels. The
+      // bands don't overlap, so neither do the pixels they write.
+      skia::RefPtr<SkCanvas> canvas =
+          skia::AdoptRef(SkCanvas::NewRasterDirect(info_, pixels_, row_bytes_));
+      renderer_->DrawBand(frame_, bands_[band], canvas.get());
+
+      base::AutoLock lock(lock_);
+      if (++bands_finished_ == band_count)
+        bands_finished_cv_.Signal();
+    }
+  }
+
+  // Waits for all bands to be drawn. Must only be called by the thread that
+  // owns the renderer.
+  void WaitForBands() {
+    int band_count = static_cast<int>(bands_.size());
+    base::AutoLock lock(lock_);
+    while (bands_finished_ < band_count)
+      bands_finished_cv_.Wait();
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<BandDrawer>;
+  ~BandDrawer() {}
+
+  SoftwareRenderer* renderer_;
+  const DrawingFrame* frame_;
+  const std::vector<gfx::Rect> bands_;
+  const SkImageInfo info_;
+  void* pixels_;
+  const size_t row_bytes_;
+
+  base::subtle::Atomic32 next_band_;
+
+  base::Lock lock_;
+  int bands_finished_;
+  base::ConditionVariable bands_finished_cv_;
+
+  DISALLOW_COPY_AND_ASSIGN(BandDrawer);
+};
+
 scoped_ptr<SoftwareRenderer> SoftwareRenderer::Create(
     RendererClient* client,
     const RendererSettings* settings,
@@ -68,7 +171,9 @@ SoftwareRenderer::SoftwareRenderer(RendererClient* client,
       is_scissor_enabled_(false),
       is_backbuffer_discarded_(false),
       output_device_(output_surface->software_device()),
-      current_canvas_(NULL) {
+      current_canvas_(NULL),
+      task_graph_runner_(nullptr),
+      drawing_in_bands_(false) {
   if (resource_provider_) {
     capabilities_.max_texture_size = resource_provider_->max_texture_size();
     capabilities_.best_texture_format =
@@ -83,7 +188,24 @@ SoftwareRenderer::SoftwareRenderer(RendererClient* client,
   capabilities_.allow_rasterize_on_demand = true;
 }
 
-SoftwareRenderer::~SoftwareRenderer() {}
+SoftwareRenderer::~SoftwareRenderer() {
+  if (!task_graph_runner_)
+    return;
+  // Band tasks left over from the last frame may still be running, and hold
+  // a reference to this renderer's BandDrawer only.
+  TaskGraph empty;
+  task_graph_runner_->ScheduleTasks(namespace_token_, &empty);
+  task_graph_runner_->WaitForTasksToFinishRunning(namespace_token_);
+  Task::Vector completed_tasks;
+  task_graph_runner_->CollectCompletedTasks(namespace_token_,
+                                            &completed_tasks);
+}
+
+void SoftwareRenderer::SetTaskGraphRunner(TaskGraphRunner* task_graph_runner) {
+  DCHECK(!task_graph_runner_);
+  task_graph_runner_ = task_graph_runner;
+  namespace_token_ = task_graph_runner_->GetNamespaceToken();
+}
 
 const RendererCapabilitiesImpl& SoftwareRenderer::Capabilities() const {
   return capabilities_;
@@ -96,6 +218,12 @@ void SoftwareRenderer::BeginDrawingFrame(DrawingFrame* frame) {
 
 void SoftwareRenderer::FinishDrawingFrame(DrawingFrame* frame) {
   TRACE_EVENT0("cc", "SoftwareRenderer::FinishDrawingFrame");
+  if (!deferred_quads_.empty())
+    DrawDeferredQuadsInBands(frame);
+  deferred_quads_.clear();
+  band_locks_.clear();
+  drawing_in_bands_ = false;
+
   current_framebuffer_lock_ = nullptr;
   current_framebuffer_canvas_.clear();
   current_canvas_ = NULL;
@@ -139,6 +267,7 @@ void SoftwareRenderer::BindFramebufferToOutputSurface(DrawingFrame* frame) {
   current_framebuffer_lock_ = nullptr;
   current_framebuffer_canvas_.clear();
   current_canvas_ = root_canvas_;
+  drawing_in_bands_ = CanDrawInBands(frame);
 }
 
 bool SoftwareRenderer::BindFramebufferToTexture(
@@ -229,16 +358,183 @@ bool SoftwareRenderer::IsSoftwareResource(ResourceId resource_id) const {
   return false;
 }
 
+const SkBitmap* SoftwareRenderer::LockBitmapForRead(
+    ResourceId resource_id,
+    scoped_ptr<ResourceProvider::ScopedReadLockSoftware>* lock) {
+  ResourceProvider::ScopedReadLockSoftware* band_lock =
+      band_locks_.get(resource_id);
+  if (!band_lock) {
+    lock->reset(new ResourceProvider::ScopedReadLockSoftware(
+        resource_provider_, resource_id));
+    band_lock = lock->get();
+  }
+  if (!band_lock->valid())
+    return nullptr;
+  return band_lock->sk_bitmap();
+}
+
+bool SoftwareRenderer::CanDrawInBands(const DrawingFrame* frame) const {
+  if (!task_graph_runner_ || settings_->software_compositor_band_count < 2 ||
+      !root_canvas_ || !resource_provider_)
+    return false;
+  const RenderPass* pass = frame->current_render_pass;
+  if (!pass || pass != frame->root_render_pass || !pass->copy_requests.empty())
+    return false;
+
+  // Bands draw straight to the pixels of the root canvas.
+  SkImageInfo info;
+  size_t row_bytes;
+  SkIPoint origin;
+  if (!root_canvas_->accessTopLayerPixels(&info, &row_bytes, &origin) ||
+      !origin.isZero() || info.height() < 2 * kMinBandHeight)
+    return false;
+
+  // Only quads that don't read back from the canvas, and whose resources can
+  // be locked up front, can be drawn in bands. Render pass quads are left out
+  // as their background filters read what is below them.
+  for (const auto& quad : pass->quad_list) {
+    if (quad->shared_quad_state->sorting_context_id != 0)
+      return false;
+    switch (quad->material) {
+      case DrawQuad::DEBUG_BORDER:
+      case DrawQuad::PICTURE_CONTENT:
+      case DrawQuad::SOLID_COLOR:
+      case DrawQuad::TILED_CONTENT:
+        break;
+      case DrawQuad::TEXTURE_CONTENT:
+        if (!IsSoftwareResource(
+                TextureDrawQuad::MaterialCast(quad)->resource_id()))
+          return false;
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+void SoftwareRenderer::DeferQuad(const DrawQuad* quad) {
+  SkISize size = current_canvas_->getDeviceSize();
+  DeferredQuad deferred_quad;
+  deferred_quad.quad = quad;
+  deferred_quad.clip_rect = gfx::Rect(size.width(), size.height());
+  if (is_scissor_enabled_)
+    deferred_quad.clip_rect.Intersect(scissor_rect_);
+  SkIRect device_clip;
+  if (current_canvas_->getClipDeviceBounds(&device_clip))
+    deferred_quad.clip_rect.Intersect(gfx::SkIRectToRect(device_clip));
+  else
+    deferred_quad.clip_rect = gfx::Rect();
+  if (deferred_quad.clip_rect.IsEmpty())
+    return;
+
+  // The resource provider can only be used on this thread, so resources are
+  // locked before the bands are drawn.
+  ResourceId resource_id = 0;
+  if (quad->material == DrawQuad::TILED_CONTENT)
+    resource_id = TileDrawQuad::MaterialCast(quad)->resource_id();
+  else if (quad->material == DrawQuad::TEXTURE_CONTENT)
+    resource_id = TextureDrawQuad::MaterialCast(quad)->resource_id();
+  if (resource_id && !band_locks_.contains(resource_id)) {
+    scoped_ptr<ResourceProvider::ScopedReadLockSoftware> lock(
+        new ResourceProvider::ScopedReadLockSoftware(resource_provider_,
+                                                     resource_id));
+    band_locks_.add(resource_id, lock.Pass());
+  }
+
+  deferred_quads_.push_back(deferred_quad);
+}
+
+void SoftwareRenderer::DrawDeferredQuadsInBands(const DrawingFrame* frame) {
+  TRACE_EVENT1("cc", "SoftwareRenderer::DrawDeferredQuadsInBands", "quads",
+               deferred_quads_.size());
+  SkImageInfo info;
+  size_t row_bytes;
+  void* pixels = root_canvas_->accessTopLayerPixels(&info, &row_bytes);
+  DCHECK(pixels);
+
+  gfx::Rect bounds;
+  for (const auto& deferred_quad : deferred_quads_)
+    bounds.Union(deferred_quad.clip_rect);
+
+  int band_count = std::min(settings_->software_compositor_band_count,
+                            std::max(bounds.height() / kMinBandHeight, 1));
+  int band_height = (bounds.height() + band_count - 1) / band_count;
+  std::vector<gfx::Rect> bands;
+  for (int y = bounds.y(); y < bounds.bottom(); y += band_height) {
+    bands.push_back(gfx::Rect(bounds.x(), y, bounds.width(),
+                              std::min(band_height, bounds.bottom() - y)));
+  }
+
+  scoped_refptr<BandDrawer> drawer(
+      new BandDrawer(this, frame, bands, info, pixels, row_bytes));
+
+  // Forget the band tasks of previous frames that are done running.
+  Task::Vector completed_tasks;
+  task_graph_runner_->CollectCompletedTasks(namespace_token_,
+                                            &completed_tasks);
+  for (const auto& task : completed_tasks) {
+    Task::Vector::iterator it =
+        std::find(band_tasks_.begin(), band_tasks_.end(), task);
+    DCHECK(it != band_tasks_.end());
+    if (it != band_tasks_.end())
+      band_tasks_.erase(it);
+  }
+
+  // The compositor thread takes a band too, so one task less than bands is
+  // needed. Tasks still pending from previous frames are replaced; they
+  // would find no band left to draw anyway.
+  TaskGraph graph;
+  Task::Vector new_tasks;
+  for (size_t i = 1; i < bands.size(); ++i) {
+    scoped_refptr<Task> task(new DrawBandsTask(
+        base::Bind(&BandDrawer::DrawBands, drawer)));
+    graph.nodes.push_back(TaskGraph::Node(task.get(), 0u, 0u));
+    new_tasks.push_back(task);
+  }
+  task_graph_runner_->ScheduleTasks(namespace_token_, &graph);
+  band_tasks_.insert(band_tasks_.end(), new_tasks.begin(), new_tasks.end());
+
+  drawer->DrawBands();
+  drawer->WaitForBands();
+}
+
+void SoftwareRenderer::DrawBand(const DrawingFrame* frame,
+                                const gfx::Rect& band_rect,
+                                SkCanvas* canvas) {
+  for (const auto& deferred_quad : deferred_quads_) {
+    gfx::Rect clip_rect =
+        gfx::IntersectRects(deferred_quad.clip_rect, band_rect);
+    if (clip_rect.IsEmpty())
+      continue;
+    canvas->resetMatrix();
+    canvas->clipRect(gfx::RectToSkRect(clip_rect), SkRegion::kReplace_Op);
+    DrawQuadToCanvas(frame, deferred_quad.quad, nullptr, canvas);
+  }
+}
+
 void SoftwareRenderer::DoDrawQuad(DrawingFrame* frame,
                                   const DrawQuad* quad,
                                   const gfx::QuadF* draw_region) {
   if (!current_canvas_)
     return;
+  if (drawing_in_bands_) {
+    DCHECK(!draw_region);
+    DeferQuad(quad);
+    return;
+  }
+  DrawQuadToCanvas(frame, quad, draw_region, current_canvas_);
+}
+
+void SoftwareRenderer::DrawQuadToCanvas(const DrawingFrame* frame,
+                                        const DrawQuad* quad,
+                                        const gfx::QuadF* draw_region,
+                                        SkCanvas* canvas) {
   if (draw_region) {
-    current_canvas_->save();
+    canvas->save();
   }
 
-  TRACE_EVENT0("cc", "SoftwareRenderer::DoDrawQuad");
+  TRACE_EVENT0("cc", "SoftwareRenderer::DrawQuadToCanvas");
   gfx::Transform quad_rect_matrix;
   QuadRectTransform(&quad_rect_matrix,
                     quad->shared_quad_state->quad_to_target_transform,
@@ -249,9 +545,9 @@ void SoftwareRenderer::DoDrawQuad(DrawingFrame* frame,
   SkMatrix sk_device_matrix;
   gfx::TransformToFlattenedSkMatrix(contents_device_transform,
                                     &sk_device_matrix);
-  current_canvas_->setMatrix(sk_device_matrix);
+  canvas->setMatrix(sk_device_matrix);
 
-  current_paint_.reset();
+  SkPaint paint;
   if (settings_->force_antialiasing ||
       !IsScaleAndIntegerTranslate(sk_device_matrix)) {
     // TODO(danakj): Until we can enable AA only on exterior edges of the
@@ -262,16 +558,16 @@ void SoftwareRenderer::DoDrawQuad(DrawingFrame* frame,
                                        quad->IsRightEdge();
     if (settings_->allow_antialiasing &&
         (settings_->force_antialiasing || all_four_edges_are_exterior))
-      current_paint_.setAntiAlias(true);
-    current_paint_.setFilterQuality(kLow_SkFilterQuality);
+      paint.setAntiAlias(true);
+    paint.setFilterQuality(kLow_SkFilterQuality);
   }
 
   if (quad->ShouldDrawWithBlending() ||
       quad->shared_quad_state->blend_mode != SkXfermode::kSrcOver_Mode) {
-    current_paint_.setAlpha(quad->shared_quad_state->opacity * 255);
-    current_paint_.setXfermodeMode(quad->shared_quad_state->blend_mode);
+    paint.setAlpha(quad->shared_quad_state->opacity * 255);
+    paint.setXfermodeMode(quad->shared_quad_state->blend_mode);
   } else {
-    current_paint_.setXfermodeMode(SkXfermode::kSrc_Mode);
+    paint.setXfermodeMode(SkXfermode::kSrc_Mode);
   }
 
   if (draw_region) {
@@ -287,28 +583,32 @@ void SoftwareRenderer::DoDrawQuad(DrawingFrame* frame,
     QuadFToSkPoints(local_draw_region, clip_points);
     draw_region_clip_path.addPoly(clip_points, 4, true);
 
-    current_canvas_->clipPath(draw_region_clip_path, SkRegion::kIntersect_Op,
-                              false);
+    canvas->clipPath(draw_region_clip_path, SkRegion::kIntersect_Op, false);
   }
 
   switch (quad->material) {
     case DrawQuad::DEBUG_BORDER:
-      DrawDebugBorderQuad(frame, DebugBorderDrawQuad::MaterialCast(quad));
+      DrawDebugBorderQuad(frame, DebugBorderDrawQuad::MaterialCast(quad),
+                          canvas, &paint);
       break;
     case DrawQuad::PICTURE_CONTENT:
-      DrawPictureQuad(frame, PictureDrawQuad::MaterialCast(quad));
+      DrawPictureQuad(frame, PictureDrawQuad::MaterialCast(quad), canvas,
+                      &paint);
       break;
     case DrawQuad::RENDER_PASS:
-      DrawRenderPassQuad(frame, RenderPassDrawQuad::MaterialCast(quad));
+      DrawRenderPassQuad(frame, RenderPassDrawQuad::MaterialCast(quad), canvas,
+                         &paint);
       break;
     case DrawQuad::SOLID_COLOR:
-      DrawSolidColorQuad(frame, SolidColorDrawQuad::MaterialCast(quad));
+      DrawSolidColorQuad(frame, SolidColorDrawQuad::MaterialCast(quad), canvas,
+                         &paint);
       break;
     case DrawQuad::TEXTURE_CONTENT:
-      DrawTextureQuad(frame, TextureDrawQuad::MaterialCast(quad));
+      DrawTextureQuad(frame, TextureDrawQuad::MaterialCast(quad), canvas,
+                      &paint);
       break;
     case DrawQuad::TILED_CONTENT:
-      DrawTileQuad(frame, TileDrawQuad::MaterialCast(quad));
+      DrawTileQuad(frame, TileDrawQuad::MaterialCast(quad), canvas, &paint);
       break;
     case DrawQuad::SURFACE_CONTENT:
       // Surface content should be fully resolved to other quad types before
@@ -319,45 +619,47 @@ void SoftwareRenderer::DoDrawQuad(DrawingFrame* frame,
     case DrawQuad::IO_SURFACE_CONTENT:
     case DrawQuad::YUV_VIDEO_CONTENT:
     case DrawQuad::STREAM_VIDEO_CONTENT:
-      DrawUnsupportedQuad(frame, quad);
+      DrawUnsupportedQuad(frame, quad, canvas, &paint);
       NOTREACHED();
       break;
   }
 
-  current_canvas_->resetMatrix();
+  canvas->resetMatrix();
   if (draw_region) {
-    current_canvas_->restore();
+    canvas->restore();
   }
 }
 
 void SoftwareRenderer::DrawDebugBorderQuad(const DrawingFrame* frame,
-                                           const DebugBorderDrawQuad* quad) {
+                                           const DebugBorderDrawQuad* quad,
+                                           SkCanvas* canvas,
+                                           SkPaint* paint) {
   // We need to apply the matrix manually to have pixel-sized stroke width.
   SkPoint vertices[4];
   gfx::RectFToSkRect(QuadVertexRect()).toQuad(vertices);
   SkPoint transformed_vertices[4];
-  current_canvas_->getTotalMatrix().mapPoints(transformed_vertices,
-                                              vertices,
-                                              4);
-  current_canvas_->resetMatrix();
-
-  current_paint_.setColor(quad->color);
-  current_paint_.setAlpha(quad->shared_quad_state->opacity *
-                          SkColorGetA(quad->color));
-  current_paint_.setStyle(SkPaint::kStroke_Style);
-  current_paint_.setStrokeWidth(quad->width);
-  current_canvas_->drawPoints(SkCanvas::kPolygon_PointMode,
-                              4, transformed_vertices, current_paint_);
+  canvas->getTotalMatrix().mapPoints(transformed_vertices, vertices, 4);
+  canvas->resetMatrix();
+
+  paint->setColor(quad->color);
+  paint->setAlpha(quad->shared_quad_state->opacity *
+                  SkColorGetA(quad->color));
+  paint->setStyle(SkPaint::kStroke_Style);
+  paint->setStrokeWidth(quad->width);
+  canvas->drawPoints(SkCanvas::kPolygon_PointMode, 4, transformed_vertices,
+                     *paint);
 }
 
 void SoftwareRenderer::DrawPictureQuad(const DrawingFrame* frame,
-                                       const PictureDrawQuad* quad) {
+                                       const PictureDrawQuad* quad,
+                                       SkCanvas* canvas,
+                                       SkPaint* paint) {
   SkMatrix content_matrix;
   content_matrix.setRectToRect(
       gfx::RectFToSkRect(quad->tex_coord_rect),
       gfx::RectFToSkRect(QuadVertexRect()),
       SkMatrix::kFill_ScaleToFit);
-  current_canvas_->concat(content_matrix);
+  canvas->concat(content_matrix);
 
   const bool needs_transparency =
       SkScalarRoundToInt(quad->shared_quad_state->opacity * 255) < 255;
@@ -370,41 +672,45 @@ void SoftwareRenderer::DrawPictureQuad(const DrawingFrame* frame,
     // TODO(aelias): This isn't correct in all cases. We should detect these
     // cases and fall back to a persistent bitmap backing
     // (http://crbug.com/280374).
-    skia::OpacityFilterCanvas filtered_canvas(current_canvas_,
+    skia::OpacityFilterCanvas filtered_canvas(canvas,
                                               quad->shared_quad_state->opacity,
                                               disable_image_filtering);
     quad->raster_source->PlaybackToSharedCanvas(
         &filtered_canvas, quad->content_rect, quad->contents_scale);
   } else {
     quad->raster_source->PlaybackToSharedCanvas(
-        current_canvas_, quad->content_rect, quad->contents_scale);
+        canvas, quad->content_rect, quad->contents_scale);
   }
 }
 
 void SoftwareRenderer::DrawSolidColorQuad(const DrawingFrame* frame,
-                                          const SolidColorDrawQuad* quad) {
+                                          const SolidColorDrawQuad* quad,
+                                          SkCanvas* canvas,
+                                          SkPaint* paint) {
   gfx::RectF visible_quad_vertex_rect = MathUtil::ScaleRectProportional(
       QuadVertexRect(), gfx::RectF(quad->rect), gfx::RectF(quad->visible_rect));
-  current_paint_.setColor(quad->color);
-  current_paint_.setAlpha(quad->shared_quad_state->opacity *
-                          SkColorGetA(quad->color));
-  current_canvas_->drawRect(gfx::RectFToSkRect(visible_quad_vertex_rect),
-                            current_paint_);
+  paint->setColor(quad->color);
+  paint->setAlpha(quad->shared_quad_state->opacity *
+                  SkColorGetA(quad->color));
+  canvas->drawRect(gfx::RectFToSkRect(visible_quad_vertex_rect), *paint);
 }
 
 void SoftwareRenderer::DrawTextureQuad(const DrawingFrame* frame,
-                                       const TextureDrawQuad* quad) {
-  if (!IsSoftwareResource(quad->resource_id())) {
-    DrawUnsupportedQuad(frame, quad);
+                                       const TextureDrawQuad* quad,
+                                       SkCanvas* canvas,
+                                       SkPaint* paint) {
+  // Resources drawn in bands were checked when they were locked.
+  if (!band_locks_.contains(quad->resource_id()) &&
+      !IsSoftwareResource(quad->resource_id())) {
+    DrawUnsupportedQuad(frame, quad, canvas, paint);
     return;
   }
 
   // TODO(skaslev): Add support for non-premultiplied alpha.
-  ResourceProvider::ScopedReadLockSoftware lock(resource_provider_,
-                                                quad->resource_id());
-  if (!lock.valid())
+  scoped_ptr<ResourceProvider::ScopedReadLockSoftware> lock;
+  const SkBitmap* bitmap = LockBitmapForRead(quad->resource_id(), &lock);
+  if (!bitmap)
     return;
-  const SkBitmap* bitmap = lock.sk_bitmap();
   gfx::RectF uv_rect = gfx::ScaleRect(gfx::BoundingRect(quad->uv_top_left,
                                                         quad->uv_bottom_right),
                                       bitmap->width(),
@@ -417,38 +723,40 @@ void SoftwareRenderer::DrawTextureQuad(const DrawingFrame* frame,
   SkRect quad_rect = gfx::RectFToSkRect(visible_quad_vertex_rect);
 
   if (quad->y_flipped)
-    current_canvas_->scale(1, -1);
+    canvas->scale(1, -1);
 
   bool blend_background = quad->background_color != SK_ColorTRANSPARENT &&
                           !bitmap->isOpaque();
-  bool needs_layer = blend_background && (current_paint_.getAlpha() != 0xFF);
+  bool needs_layer = blend_background && (paint->getAlpha() != 0xFF);
   if (needs_layer) {
-    current_canvas_->saveLayerAlpha(&quad_rect, current_paint_.getAlpha());
-    current_paint_.setAlpha(0xFF);
+    canvas->saveLayerAlpha(&quad_rect, paint->getAlpha());
+    paint->setAlpha(0xFF);
   }
   if (blend_background) {
     SkPaint background_paint;
     background_paint.setColor(quad->background_color);
-    current_canvas_->drawRect(quad_rect, background_paint);
+    canvas->drawRect(quad_rect, background_paint);
   }
-  current_paint_.setFilterQuality(
+  paint->setFilterQuality(
       quad->nearest_neighbor ? kNone_SkFilterQuality : kLow_SkFilterQuality);
-  current_canvas_->drawBitmapRect(*bitmap, sk_uv_rect, quad_rect,
-                                  &current_paint_);
+  canvas->drawBitmapRect(*bitmap, sk_uv_rect, quad_rect, paint);
   if (needs_layer)
-    current_canvas_->restore();
+    canvas->restore();
 }
 
 void SoftwareRenderer::DrawTileQuad(const DrawingFrame* frame,
-                                    const TileDrawQuad* quad) {
+                                    const TileDrawQuad* quad,
+                                    SkCanvas* canvas,
+                                    SkPaint* paint) {
   // |resource_provider_| can be NULL in resourceless software draws, which
   // should never produce tile quads in the first place.
   DCHECK(resource_provider_);
-  DCHECK(IsSoftwareResource(quad->resource_id()));
+  DCHECK(band_locks_.contains(quad->resource_id()) ||
+         IsSoftwareResource(quad->resource_id()));
 
-  ResourceProvider::ScopedReadLockSoftware lock(resource_provider_,
-                                                quad->resource_id());
-  if (!lock.valid())
+  scoped_ptr<ResourceProvider::ScopedReadLockSoftware> lock;
+  const SkBitmap* bitmap = LockBitmapForRead(quad->resource_id(), &lock);
+  if (!bitmap)
     return;
 
   gfx::RectF visible_tex_coord_rect = MathUtil::ScaleRectProportional(
@@ -458,15 +766,16 @@ void SoftwareRenderer::DrawTileQuad(const DrawingFrame* frame,
       QuadVertexRect(), gfx::RectF(quad->rect), gfx::RectF(quad->visible_rect));
 
   SkRect uv_rect = gfx::RectFToSkRect(visible_tex_coord_rect);
-  current_paint_.setFilterQuality(
+  paint->setFilterQuality(
       quad->nearest_neighbor ? kNone_SkFilterQuality : kLow_SkFilterQuality);
-  current_canvas_->drawBitmapRect(*lock.sk_bitmap(), uv_rect,
-                                  gfx::RectFToSkRect(visible_quad_vertex_rect),
-                                  &current_paint_);
+  canvas->drawBitmapRect(*bitmap, uv_rect,
+                         gfx::RectFToSkRect(visible_quad_vertex_rect), paint);
 }
 
 void SoftwareRenderer::DrawRenderPassQuad(const DrawingFrame* frame,
-                                          const RenderPassDrawQuad* quad) {
+                                          const RenderPassDrawQuad* quad,
+                                          SkCanvas* canvas,
+                                          SkPaint* paint) {
   ScopedResource* content_texture =
       render_pass_textures_.get(quad->render_pass_id);
   DCHECK(content_texture);
@@ -543,32 +852,33 @@ void SoftwareRenderer::DrawRenderPassQuad(const DrawingFrame* frame,
     skia::RefPtr<SkLayerRasterizer> mask_rasterizer =
         skia::AdoptRef(builder.detachRasterizer());
 
-    current_paint_.setRasterizer(mask_rasterizer.get());
+    paint->setRasterizer(mask_rasterizer.get());
   }
 
   // If we have a background filter shader, render its results first.
   skia::RefPtr<SkShader> background_filter_shader =
-      GetBackgroundFilterShader(frame, quad, SkShader::kClamp_TileMode);
+      GetBackgroundFilterShader(frame, quad, canvas, SkShader::kClamp_TileMode);
   if (background_filter_shader) {
-    SkPaint paint;
-    paint.setShader(background_filter_shader.get());
-    paint.setRasterizer(current_paint_.getRasterizer());
-    current_canvas_->drawRect(dest_visible_rect, paint);
+    SkPaint background_paint;
+    background_paint.setShader(background_filter_shader.get());
+    background_paint.setRasterizer(paint->getRasterizer());
+    canvas->drawRect(dest_visible_rect, background_paint);
   }
-  current_paint_.setShader(shader.get());
-  current_canvas_->drawRect(dest_visible_rect, current_paint_);
+  paint->setShader(shader.get());
+  canvas->drawRect(dest_visible_rect, *paint);
 }
 
 void SoftwareRenderer::DrawUnsupportedQuad(const DrawingFrame* frame,
-                                           const DrawQuad* quad) {
+                                           const DrawQuad* quad,
+                                           SkCanvas* canvas,
+                                           SkPaint* paint) {
 #ifdef NDEBUG
-  current_paint_.setColor(SK_ColorWHITE);
+  paint->setColor(SK_ColorWHITE);
 #else
-  current_paint_.setColor(SK_ColorMAGENTA);
+  paint->setColor(SK_ColorMAGENTA);
 #endif
-  current_paint_.setAlpha(quad->shared_quad_state->opacity * 255);
-  current_canvas_->drawRect(gfx::RectFToSkRect(QuadVertexRect()),
-                            current_paint_);
+  paint->setAlpha(quad->shared_quad_state->opacity * 255);
+  canvas->drawRect(gfx::RectFToSkRect(QuadVertexRect()), *paint);
 }
 
 void SoftwareRenderer::CopyCurrentRenderPassToBitmap(
@@ -648,11 +958,12 @@ SkBitmap SoftwareRenderer::ApplyImageFilter(SkImageFilter* filter,
 }
 
 SkBitmap SoftwareRenderer::GetBackdropBitmap(
+    SkCanvas* canvas,
     const gfx::Rect& bounding_rect) const {
   SkBitmap bitmap;
   bitmap.setInfo(SkImageInfo::MakeN32Premul(bounding_rect.width(),
                                             bounding_rect.height()));
-  current_canvas_->readPixels(&bitmap, bounding_rect.x(), bounding_rect.y());
+  canvas->readPixels(&bitmap, bounding_rect.x(), bounding_rect.y());
   return bitmap;
 }
 
@@ -677,6 +988,7 @@ gfx::Rect SoftwareRenderer::GetBackdropBoundingBoxForRenderPassQuad(
 skia::RefPtr<SkShader> SoftwareRenderer::GetBackgroundFilterShader(
     const DrawingFrame* frame,
     const RenderPassDrawQuad* quad,
+    SkCanvas* canvas,
     SkShader::TileMode content_tile_mode) const {
   if (!ShouldApplyBackgroundFilters(quad))
     return skia::RefPtr<SkShader>();
@@ -702,7 +1014,7 @@ skia::RefPtr<SkShader> SoftwareRenderer::GetBackgroundFilterShader(
   filter_backdrop_transform.preTranslate(backdrop_rect.x(), backdrop_rect.y());
 
   // Draw what's behind, and apply the filter to it.
-  SkBitmap backdrop_bitmap = GetBackdropBitmap(backdrop_rect);
+  SkBitmap backdrop_bitmap = GetBackdropBitmap(canvas, backdrop_rect);
 
   skia::RefPtr<SkImageFilter> filter = RenderSurfaceFilters::BuildImageFilter(
       quad->background_filters,
@@ -5,10 +5,14 @@
 #ifndef CC_OUTPUT_SOFTWARE_RENDERER_H_
 #define CC_OUTPUT_SOFTWARE_RENDERER_H_
 
+#include <vector>
+
 #include "base/basictypes.h"
+#include "base/containers/scoped_ptr_hash_map.h"
 #include "cc/base/cc_export.h"
 #include "cc/output/compositor_frame.h"
 #include "cc/output/direct_renderer.h"
+#include "cc/raster/task_graph_runner.h"
 
 namespace cc {
 
@@ -40,6 +44,11 @@ class CC_EXPORT SoftwareRenderer : public DirectRenderer {
   void DiscardBackbuffer() override;
   void EnsureBackbuffer() override;
 
+  // Lets the root render pass be drawn in horizontal bands, in parallel on
+  // the workers of |task_graph_runner|. How many bands are used is set by
+  // RendererSettings::software_compositor_band_count.
+  void SetTaskGraphRunner(TaskGraphRunner* task_graph_runner);
+
  protected:
   void BindFramebufferToOutputSurface(DrawingFrame* frame) override;
   bool BindFramebufferToTexture(DrawingFrame* frame,
@@ -70,27 +79,70 @@ class CC_EXPORT SoftwareRenderer : public DirectRenderer {
   void DidChangeVisibility() override;
 
  private:
+  class BandDrawer;
+
+  // A quad of the root render pass, and the rect it is clipped to, whose
+  // drawing is deferred until the bands are drawn.
+  struct DeferredQuad {
+    const DrawQuad* quad;
+    gfx::Rect clip_rect;
+  };
+
   void ClearCanvas(SkColor color);
   void ClearFramebuffer(DrawingFrame* frame);
   void SetClipRect(const gfx::Rect& rect);
   bool IsSoftwareResource(ResourceId resource_id) const;
 
-  void DrawCheckerboardQuad(const DrawingFrame* frame,
-                            const CheckerboardDrawQuad* quad);
+  // Returns the bitmap of |resource_id|, or null if it can't be locked. The
+  // resource is locked in |lock|, unless it was locked up front for drawing
+  // in bands.
+  const SkBitmap* LockBitmapForRead(
+      ResourceId resource_id,
+      scoped_ptr<ResourceProvider::ScopedReadLockSoftware>* lock);
+
+  // Drawing in bands.
+  bool CanDrawInBands(const DrawingFrame* frame) const;
+  void DeferQuad(const DrawQuad* quad);
+  void DrawDeferredQuadsInBands(const DrawingFrame* frame);
+  // Called on worker threads.
+  void DrawBand(const DrawingFrame* frame,
+                const gfx::Rect& band_rect,
+                SkCanvas* canvas);
+
+  // The functions below draw to |canvas| and are called on worker threads
+  // when drawing in bands.
+  void DrawQuadToCanvas(const DrawingFrame* frame,
+                        const DrawQuad* quad,
+                        const gfx::QuadF* draw_region,
+                        SkCanvas* canvas);
   void DrawDebugBorderQuad(const DrawingFrame* frame,
-                           const DebugBorderDrawQuad* quad);
+                           const DebugBorderDrawQuad* quad,
+                           SkCanvas* canvas,
+                           SkPaint* paint);
   void DrawPictureQuad(const DrawingFrame* frame,
-                       const PictureDrawQuad* quad);
+                       const PictureDrawQuad* quad,
+                       SkCanvas* canvas,
+                       SkPaint* paint);
   void DrawRenderPassQuad(const DrawingFrame* frame,
-                          const RenderPassDrawQuad* quad);
+                          const RenderPassDrawQuad* quad,
+                          SkCanvas* canvas,
+                          SkPaint* paint);
   void DrawSolidColorQuad(const DrawingFrame* frame,
-                          const SolidColorDrawQuad* quad);
+                          const SolidColorDrawQuad* quad,
+                          SkCanvas* canvas,
+                          SkPaint* paint);
   void DrawTextureQuad(const DrawingFrame* frame,
-                       const TextureDrawQuad* quad);
+                       const TextureDrawQuad* quad,
+                       SkCanvas* canvas,
+                       SkPaint* paint);
   void DrawTileQuad(const DrawingFrame* frame,
-                    const TileDrawQuad* quad);
+                    const TileDrawQuad* quad,
+                    SkCanvas* canvas,
+                    SkPaint* paint);
   void DrawUnsupportedQuad(const DrawingFrame* frame,
-                           const DrawQuad* quad);
+                           const DrawQuad* quad,
+                           SkCanvas* canvas,
+                           SkPaint* paint);
   bool ShouldApplyBackgroundFilters(const RenderPassDrawQuad* quad) const;
   SkBitmap ApplyImageFilter(SkImageFilter* filter,
                             const RenderPassDrawQuad* quad,
@@ -99,10 +151,12 @@ class CC_EXPORT SoftwareRenderer : public DirectRenderer {
       const DrawingFrame* frame,
       const RenderPassDrawQuad* quad,
       const gfx::Transform& contents_device_transform) const;
-  SkBitmap GetBackdropBitmap(const gfx::Rect& bounding_rect) const;
+  SkBitmap GetBackdropBitmap(SkCanvas* canvas,
+                             const gfx::Rect& bounding_rect) const;
   skia::RefPtr<SkShader> GetBackgroundFilterShader(
       const DrawingFrame* frame,
       const RenderPassDrawQuad* quad,
+      SkCanvas* canvas,
       SkShader::TileMode content_tile_mode) const;
 
   RendererCapabilitiesImpl capabilities_;
@@ -113,11 +167,22 @@ class CC_EXPORT SoftwareRenderer : public DirectRenderer {
   SoftwareOutputDevice* output_device_;
   SkCanvas* root_canvas_;
   SkCanvas* current_canvas_;
-  SkPaint current_paint_;
   scoped_ptr<ResourceProvider::ScopedWriteLockSoftware>
       current_framebuffer_lock_;
   skia::RefPtr<SkCanvas> current_framebuffer_canvas_;
 
+  TaskGraphRunner* task_graph_runner_;
+  NamespaceToken namespace_token_;
+  // Band tasks that were scheduled and not collected yet.
+  Task::Vector band_tasks_;
+
+  // Set while the quads of the root render pass are deferred.
+  bool drawing_in_bands_;
+  std::vector<DeferredQuad> deferred_quads_;
+  base::ScopedPtrHashMap<ResourceId,
+                         scoped_ptr<ResourceProvider::ScopedReadLockSoftware>>
+      band_locks_;
+
   DISALLOW_COPY_AND_ASSIGN(SoftwareRenderer);
 };
 
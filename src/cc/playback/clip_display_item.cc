@@ -76,6 +76,12 @@ void ClipDisplayItem::Raster(SkCanvas* canvas,
   }
 }
 
+bool ClipDisplayItem::GetSubtreeBounds(SkRect* bounds) const {
+  // The rounded clips can only make the clip smaller.
+  *bounds = gfx::RectToSkRect(clip_rect_);
+  return true;
+}
+
 void ClipDisplayItem::AsValueInto(base::trace_event::TracedValue* array) const {
   std::string value = base::StringPrintf("ClipDisplayItem rect: [%s]",
                                          clip_rect_.ToString().c_str());
@@ -124,6 +130,10 @@ void EndClipDisplayItem::Raster(SkCanvas* canvas,
   canvas->restore();
 }
 
+bool EndClipDisplayItem::EndsBoundedSubtree() const {
+  return true;
+}
+
 void EndClipDisplayItem::AsValueInto(
     base::trace_event::TracedValue* array) const {
   array->AppendString("EndClipDisplayItem");
@@ -31,6 +31,7 @@ class CC_EXPORT ClipDisplayItem : public DisplayItem {
               const gfx::Rect& canvas_target_playback_rect,
               SkPicture::AbortCallback* callback) const override;
   void AsValueInto(base::trace_event::TracedValue* array) const override;
+  bool GetSubtreeBounds(SkRect* bounds) const override;
 
  private:
   gfx::Rect clip_rect_;
@@ -48,6 +49,7 @@ class CC_EXPORT EndClipDisplayItem : public DisplayItem {
               const gfx::Rect& canvas_target_playback_rect,
               SkPicture::AbortCallback* callback) const override;
   void AsValueInto(base::trace_event::TracedValue* array) const override;
+  bool EndsBoundedSubtree() const override;
 };
 
 }  // namespace cc
@@ -129,10 +129,10 @@ void DiscardableImageMap::GetDiscardableImagesInRect(
     const gfx::Rect& rect,
     float raster_scale,
     std::vector<DrawImage>* images) const {
-  std::vector<size_t> indices;
-  images_rtree_.Search(gfx::RectF(rect), &indices);
-  for (size_t index : indices)
-    images->push_back(all_images_[index].first.ApplyScale(raster_scale));
+  images_rtree_.ForEachIntersecting(
+      gfx::RectF(rect), [this, raster_scale, images](size_t index) {
+        images->push_back(all_images_[index].first.ApplyScale(raster_scale));
+      });
 }
 
 DiscardableImageMap::ScopedMetadataGenerator::ScopedMetadataGenerator(
@@ -38,6 +38,16 @@ class CC_EXPORT DisplayItem {
                       SkPicture::AbortCallback* callback) const = 0;
   virtual void AsValueInto(base::trace_event::TracedValue* array) const = 0;
 
+  // If nothing drawn between this item and its matching end item can land
+  // outside a known rect, sets |bounds| to that rect, in the space of the
+  // canvas when this item is rastered, and returns true. DisplayItemList uses
+  // this to skip whole subtrees that are outside the playback rect.
+  virtual bool GetSubtreeBounds(SkRect* bounds) const { return false; }
+
+  // Returns true if this item ends a subtree begun by an item whose
+  // GetSubtreeBounds() returns true.
+  virtual bool EndsBoundedSubtree() const { return false; }
+
   bool is_suitable_for_gpu_rasterization() const {
     return is_suitable_for_gpu_rasterization_;
   }
@@ -112,8 +112,27 @@ void DisplayItemList::Raster(SkCanvas* canvas,
   if (!settings_.use_cached_picture) {
     canvas->save();
     canvas->scale(contents_scale, contents_scale);
-    for (auto* item : items_)
+    // The playback rect can be empty to signify no culling is desired.
+    bool can_skip_subtrees = !canvas_target_playback_rect.IsEmpty() &&
+                             subtree_end_indices_.size() == items_.size();
+    SkRect target_rect = gfx::RectToSkRect(canvas_target_playback_rect);
+    for (auto it = items_.cbegin(); it != items_.cend(); ++it) {
+      const DisplayItem* item = *it;
+      SkRect subtree_bounds;
+      if (can_skip_subtrees && item->GetSubtreeBounds(&subtree_bounds)) {
+        SkRect device_bounds;
+        canvas->getTotalMatrix().mapRect(&device_bounds, subtree_bounds);
+        if (!device_bounds.intersect(target_rect)) {
+          // Nothing in the subtree can be visible. Skip to its end item, which
+          // is skipped as well since its begin item is not rastered.
+          size_t end_index = subtree_end_indices_[it.index()];
+          while (it.index() != end_index)
+            ++it;
+          continue;
+        }
+      }
       item->Raster(canvas, canvas_target_playback_rect, callback);
+    }
     canvas->restore();
   } else {
     DCHECK(picture_);
@@ -197,11 +216,38 @@ void DisplayItemList::RemoveLast() {
   DCHECK(retain_individual_display_items_);
   DCHECK(!settings_.use_cached_picture);
   items_.RemoveLast();
+  subtree_end_indices_.clear();
+}
+
+void DisplayItemList::IndexBoundedSubtrees() {
+  subtree_end_indices_.assign(items_.size(), 0u);
+  std::vector<size_t> begin_indices;
+  for (auto it = items_.cbegin(); it != items_.cend(); ++it) {
+    SkRect bounds;
+    if ((*it)->GetSubtreeBounds(&bounds)) {
+      begin_indices.push_back(it.index());
+    } else if ((*it)->EndsBoundedSubtree()) {
+      // Lists that don't pair up, e.g. because they came from a bad proto,
+      // are rastered item by item.
+      if (begin_indices.empty()) {
+        subtree_end_indices_.clear();
+        return;
+      }
+      subtree_end_indices_[begin_indices.back()] = it.index();
+      begin_indices.pop_back();
+    }
+  }
+
+  if (!begin_indices.empty())
+    subtree_end_indices_.clear();
 }
 
 void DisplayItemList::Finalize() {
   ProcessAppendedItems();
 
+  if (retain_individual_display_items_ && !settings_.use_cached_picture)
+    IndexBoundedSubtrees();
+
   if (settings_.use_cached_picture) {
     // Convert to an SkPicture for faster rasterization.
     DCHECK(settings_.use_cached_picture);
@@ -239,6 +285,7 @@ size_t DisplayItemList::ApproximateMemoryUsage() const {
 
   // Memory outside this class due to |items_|.
   memory_usage += items_.GetCapacityInBytes() + external_memory_usage_;
+  memory_usage += subtree_end_indices_.capacity() * sizeof(size_t);
 
   // Memory outside this class due to |picture|.
   memory_usage += picture_memory_usage_;
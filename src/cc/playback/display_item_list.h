@@ -112,7 +112,15 @@ class CC_EXPORT DisplayItemList
   bool ProcessAppendedItemsCalled() const { return true; }
 #endif
 
+  // Pairs the items that begin and end bounded subtrees, see
+  // DisplayItem::GetSubtreeBounds().
+  void IndexBoundedSubtrees();
+
   ListContainer<DisplayItem> items_;
+
+  // For each item of |items_| that begins a bounded subtree, the index of the
+  // item that ends it. Either empty or the same size as |items_|.
+  std::vector<size_t> subtree_end_indices_;
   skia::RefPtr<SkPicture> picture_;
 
   scoped_ptr<SkPictureRecorder> recorder_;
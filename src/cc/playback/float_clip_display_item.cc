@@ -49,6 +49,11 @@ void FloatClipDisplayItem::Raster(SkCanvas* canvas,
   canvas->clipRect(gfx::RectFToSkRect(clip_rect_));
 }
 
+bool FloatClipDisplayItem::GetSubtreeBounds(SkRect* bounds) const {
+  *bounds = gfx::RectFToSkRect(clip_rect_);
+  return true;
+}
+
 void FloatClipDisplayItem::AsValueInto(
     base::trace_event::TracedValue* array) const {
   array->AppendString(base::StringPrintf("FloatClipDisplayItem rect: [%s]",
@@ -78,6 +83,10 @@ void EndFloatClipDisplayItem::Raster(
   canvas->restore();
 }
 
+bool EndFloatClipDisplayItem::EndsBoundedSubtree() const {
+  return true;
+}
+
 void EndFloatClipDisplayItem::AsValueInto(
     base::trace_event::TracedValue* array) const {
   array->AppendString("EndFloatClipDisplayItem");
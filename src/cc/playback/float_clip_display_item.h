@@ -29,6 +29,7 @@ class CC_EXPORT FloatClipDisplayItem : public DisplayItem {
               const gfx::Rect& canvas_target_playback_rect,
               SkPicture::AbortCallback* callback) const override;
   void AsValueInto(base::trace_event::TracedValue* array) const override;
+  bool GetSubtreeBounds(SkRect* bounds) const override;
 
  private:
   gfx::RectF clip_rect_;
@@ -49,6 +50,7 @@ class CC_EXPORT EndFloatClipDisplayItem : public DisplayItem {
               const gfx::Rect& canvas_target_playback_rect,
               SkPicture::AbortCallback* callback) const override;
   void AsValueInto(base::trace_event::TracedValue* array) const override;
+  bool EndsBoundedSubtree() const override;
 };
 
 }  // namespace cc
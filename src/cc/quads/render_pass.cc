@@ -53,6 +53,8 @@ scoped_ptr<RenderPass> RenderPass::Create(size_t shared_quad_state_list_size,
 
 RenderPass::RenderPass()
     : has_transparent_background(true),
+      cache_contents(false),
+      use_cached_contents(false),
       quad_list(kDefaultNumQuadsToReserve),
       shared_quad_state_list(sizeof(SharedQuadState),
                              kDefaultNumSharedQuadStatesToReserve) {
@@ -62,6 +64,8 @@ RenderPass::RenderPass()
 // is a good hint for what to reserve here.
 RenderPass::RenderPass(size_t num_layers)
     : has_transparent_background(true),
+      cache_contents(false),
+      use_cached_contents(false),
       quad_list(kDefaultNumQuadsToReserve),
       shared_quad_state_list(sizeof(SharedQuadState), num_layers) {
 }
@@ -69,6 +73,8 @@ RenderPass::RenderPass(size_t num_layers)
 RenderPass::RenderPass(size_t shared_quad_state_list_size,
                        size_t quad_list_size)
     : has_transparent_background(true),
+      cache_contents(false),
+      use_cached_contents(false),
       quad_list(quad_list_size),
       shared_quad_state_list(sizeof(SharedQuadState),
                              shared_quad_state_list_size) {
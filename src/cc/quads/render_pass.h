@@ -108,6 +108,17 @@ class CC_EXPORT RenderPass {
   // If false, the pixels in the render pass' texture are all opaque.
   bool has_transparent_background;
 
+  // Set by the SurfaceAggregator on passes it expects to be unchanged in the
+  // next frame. The renderer draws them in full, whatever the damage, and
+  // keeps their contents for later frames.
+  bool cache_contents;
+
+  // Set by the SurfaceAggregator on passes whose contents the renderer cached
+  // in an earlier frame and that haven't changed since. They have no quads,
+  // and the renderer keeps the contents it has instead of drawing them. Like
+  // |cache_contents|, this is not serialized between compositors.
+  bool use_cached_contents;
+
   // If non-empty, the renderer should produce a copy of the render pass'
   // contents as a bitmap, and give a copy of the bitmap to each callback in
   // this list. This property should not be serialized between compositors, as
@@ -14,61 +14,109 @@
 namespace cc {
 namespace {
 
-// Helper class for iterating over all dependents of a task.
+typedef std::vector<std::pair<const Task*, size_t>> NodeIndex;
+
+bool CompareEdgeTask(const TaskGraph::Edge& edge, const Task* task) {
+  return std::less<const Task*>()(edge.task, task);
+}
+
+bool CompareNodeIndexTask(const std::pair<const Task*, size_t>& entry,
+                          const Task* task) {
+  return std::less<const Task*>()(entry.first, task);
+}
+
+// Returns the entry for |task| in |node_indices|, or NULL if |task| is not in
+// the indexed graph.
+const std::pair<const Task*, size_t>* FindNodeIndex(
+    const NodeIndex& node_indices,
+    const Task* task) {
+  NodeIndex::const_iterator it =
+      std::lower_bound(node_indices.begin(), node_indices.end(), task,
+                       CompareNodeIndexTask);
+  if (it == node_indices.end() || it->first != task)
+    return NULL;
+  return &*it;
+}
+
+// Helper class for iterating over all dependents of a task. The edges of
+// |graph| must be sorted by task and |node_indices| must index its nodes,
+// see IndexTaskGraph().
 class DependentIterator {
  public:
-  DependentIterator(TaskGraph* graph, const Task* task)
+  DependentIterator(TaskGraph* graph,
+                    const NodeIndex& node_indices,
+                    const Task* task)
       : graph_(graph),
+        node_indices_(node_indices),
         task_(task),
-        current_index_(static_cast<size_t>(-1)),
+        current_index_(static_cast<size_t>(
+            std::lower_bound(graph->edges.begin(), graph->edges.end(), task,
+                             CompareEdgeTask) -
+            graph->edges.begin())),
         current_node_(NULL) {
-    ++(*this);
+    UpdateCurrentNode();
   }
 
   TaskGraph::Node& operator->() const {
-    DCHECK_LT(current_index_, graph_->edges.size());
-    DCHECK_EQ(graph_->edges[current_index_].task, task_);
+    DCHECK(*this);
     DCHECK(current_node_);
     return *current_node_;
   }
 
   TaskGraph::Node& operator*() const {
-    DCHECK_LT(current_index_, graph_->edges.size());
-    DCHECK_EQ(graph_->edges[current_index_].task, task_);
+    DCHECK(*this);
     DCHECK(current_node_);
     return *current_node_;
   }
 
-  // Note: Performance can be improved by keeping edges sorted.
   DependentIterator& operator++() {
-    // Find next dependency edge for |task_|.
-    do {
-      ++current_index_;
-      if (current_index_ == graph_->edges.size())
-        return *this;
-    } while (graph_->edges[current_index_].task != task_);
-
-    // Now find the node for the dependent of this edge.
-    TaskGraph::Node::Vector::iterator it =
-        std::find_if(graph_->nodes.begin(),
-                     graph_->nodes.end(),
-                     TaskGraph::Node::TaskComparator(
-                         graph_->edges[current_index_].dependent));
-    DCHECK(it != graph_->nodes.end());
-    current_node_ = &(*it);
-
+    ++current_index_;
+    UpdateCurrentNode();
     return *this;
   }
 
-  operator bool() const { return current_index_ < graph_->edges.size(); }
+  operator bool() const {
+    return current_index_ < graph_->edges.size() &&
+           graph_->edges[current_index_].task == task_;
+  }
 
  private:
+  // Finds the node for the dependent of the current edge.
+  void UpdateCurrentNode() {
+    current_node_ = NULL;
+    if (!*this)
+      return;
+    const std::pair<const Task*, size_t>* entry =
+        FindNodeIndex(node_indices_, graph_->edges[current_index_].dependent);
+    DCHECK(entry);
+    current_node_ = &graph_->nodes[entry->second];
+  }
+
   TaskGraph* graph_;
+  const NodeIndex& node_indices_;
   const Task* task_;
   size_t current_index_;
   TaskGraph::Node* current_node_;
 };
 
+// Sorts the edges of |graph| by task and maps its tasks to their nodes, so
+// that the dependents of a task can be found without searching the graph.
+void IndexTaskGraph(TaskGraph* graph, NodeIndex* node_indices) {
+  std::sort(graph->edges.begin(), graph->edges.end(),
+            [](const TaskGraph::Edge& a, const TaskGraph::Edge& b) {
+              return std::less<const Task*>()(a.task, b.task);
+            });
+  node_indices->clear();
+  node_indices->reserve(graph->nodes.size());
+  for (size_t i = 0; i < graph->nodes.size(); ++i)
+    node_indices->push_back(std::make_pair(graph->nodes[i].task, i));
+  std::sort(node_indices->begin(), node_indices->end(),
+            [](const std::pair<const Task*, size_t>& a,
+               const std::pair<const Task*, size_t>& b) {
+              return std::less<const Task*>()(a.first, b.first);
+            });
+}
+
 bool DependencyMismatch(const TaskGraph* graph) {
   // Value storage will be 0-initialized.
   base::hash_map<const Task*, size_t> dependents;
@@ -120,13 +168,30 @@ void TaskGraph::Reset() {
   edges.clear();
 }
 
+struct TaskGraphRunner::Worker {
+  Worker(base::Lock* lock, const std::vector<uint16_t>& categories)
+      : categories(categories), wake_up_cv(lock) {}
+
+  bool CanRun(uint16_t category) const {
+    return categories.empty() ||
+           std::find(categories.begin(), categories.end(), category) !=
+               categories.end();
+  }
+
+  // Categories of tasks this worker runs, in order of preference. Empty if
+  // it runs tasks of any category.
+  const std::vector<uint16_t> categories;
+
+  // Signaled when tasks this worker can run are ready, or on shutdown.
+  base::ConditionVariable wake_up_cv;
+};
+
 TaskGraphRunner::TaskNamespace::TaskNamespace() {}
 
 TaskGraphRunner::TaskNamespace::~TaskNamespace() {}
 
 TaskGraphRunner::TaskGraphRunner()
     : lock_(),
-      has_ready_to_run_tasks_cv_(&lock_),
       has_namespaces_with_finished_running_tasks_cv_(&lock_),
       next_namespace_id_(1),
       shutdown_(false) {}
@@ -137,6 +202,7 @@ TaskGraphRunner::~TaskGraphRunner() {
 
     DCHECK_EQ(0u, ready_to_run_namespaces_.size());
     DCHECK_EQ(0u, namespaces_.size());
+    DCHECK_EQ(0u, idle_workers_.size());
   }
 }
 
@@ -159,6 +225,11 @@ void TaskGraphRunner::ScheduleTasks(NamespaceToken token, TaskGraph* graph) {
   DCHECK(token.IsValid());
   DCHECK(!DependencyMismatch(graph));
 
+  // Index the new graph before acquiring |lock_|, as it is not shared with
+  // workers until it is swapped in below.
+  NodeIndex node_indices;
+  IndexTaskGraph(graph, &node_indices);
+
   {
     base::AutoLock lock(lock_);
 
@@ -170,32 +241,21 @@ void TaskGraphRunner::ScheduleTasks(NamespaceToken token, TaskGraph* graph) {
     for (Task::Vector::iterator it = task_namespace.completed_tasks.begin();
          it != task_namespace.completed_tasks.end();
          ++it) {
-      for (DependentIterator node_it(graph, it->get()); node_it; ++node_it) {
+      for (DependentIterator node_it(graph, node_indices, it->get()); node_it;
+           ++node_it) {
         TaskGraph::Node& node = *node_it;
         DCHECK_LT(0u, node.dependencies);
         node.dependencies--;
       }
     }
 
-    // Build new "ready to run" queue and remove nodes from old graph.
+    // Build new "ready to run" queues.
     task_namespace.ready_to_run_tasks.clear();
     for (TaskGraph::Node::Vector::iterator it = graph->nodes.begin();
          it != graph->nodes.end();
          ++it) {
       TaskGraph::Node& node = *it;
 
-      // Remove any old nodes that are associated with this task. The result is
-      // that the old graph is left with all nodes not present in this graph,
-      // which we use below to determine what tasks need to be canceled.
-      TaskGraph::Node::Vector::iterator old_it =
-          std::find_if(task_namespace.graph.nodes.begin(),
-                       task_namespace.graph.nodes.end(),
-                       TaskGraph::Node::TaskComparator(node.task));
-      if (old_it != task_namespace.graph.nodes.end()) {
-        std::swap(*old_it, task_namespace.graph.nodes.back());
-        task_namespace.graph.nodes.pop_back();
-      }
-
       // Task is not ready to run if dependencies are not yet satisfied.
       if (node.dependencies)
         continue;
@@ -210,18 +270,20 @@ void TaskGraphRunner::ScheduleTasks(NamespaceToken token, TaskGraph* graph) {
                     node.task) != task_namespace.running_tasks.end())
         continue;
 
-      task_namespace.ready_to_run_tasks.push_back(
+      task_namespace.ready_to_run_tasks[node.category].push_back(
           PrioritizedTask(node.task, node.priority));
     }
 
-    // Rearrange the elements in |ready_to_run_tasks| in such a way that they
-    // form a heap.
-    std::make_heap(task_namespace.ready_to_run_tasks.begin(),
-                   task_namespace.ready_to_run_tasks.end(),
-                   CompareTaskPriority);
+    // Rearrange the elements in each of the |ready_to_run_tasks| in such a way
+    // that they form a heap.
+    for (auto& ready_to_run_tasks : task_namespace.ready_to_run_tasks) {
+      std::make_heap(ready_to_run_tasks.second.begin(),
+                     ready_to_run_tasks.second.end(), CompareTaskPriority);
+    }
 
-    // Swap task graph.
+    // Swap task graph. The old graph is left in |graph|.
     task_namespace.graph.Swap(graph);
+    task_namespace.node_indices.swap(node_indices);
 
     // Determine what tasks in old graph need to be canceled.
     for (TaskGraph::Node::Vector::iterator it = graph->nodes.begin();
@@ -229,6 +291,10 @@ void TaskGraphRunner::ScheduleTasks(NamespaceToken token, TaskGraph* graph) {
          ++it) {
       TaskGraph::Node& node = *it;
 
+      // Skip if still part of the new graph.
+      if (FindNodeIndex(task_namespace.node_indices, node.task))
+        continue;
+
       // Skip if already finished running task.
       if (node.task->HasFinishedRunning())
         continue;
@@ -245,24 +311,28 @@ void TaskGraphRunner::ScheduleTasks(NamespaceToken token, TaskGraph* graph) {
       task_namespace.completed_tasks.push_back(node.task);
     }
 
-    // Build new "ready to run" task namespaces queue.
+    // Build new "ready to run" task namespaces queues.
     ready_to_run_namespaces_.clear();
     for (TaskNamespaceMap::iterator it = namespaces_.begin();
          it != namespaces_.end();
          ++it) {
-      if (!it->second.ready_to_run_tasks.empty())
-        ready_to_run_namespaces_.push_back(&it->second);
+      for (const auto& ready_to_run_tasks : it->second.ready_to_run_tasks) {
+        ready_to_run_namespaces_[ready_to_run_tasks.first].push_back(
+            &it->second);
+      }
     }
 
-    // Rearrange the task namespaces in |ready_to_run_namespaces_| in such a way
-    // that they form a heap.
-    std::make_heap(ready_to_run_namespaces_.begin(),
-                   ready_to_run_namespaces_.end(),
-                   CompareTaskNamespacePriority);
+    // Rearrange the task namespaces in each of the |ready_to_run_namespaces_|
+    // in such a way that they form a heap.
+    for (auto& ready_to_run_namespaces : ready_to_run_namespaces_) {
+      std::make_heap(ready_to_run_namespaces.second.begin(),
+                     ready_to_run_namespaces.second.end(),
+                     CompareTaskNamespacePriority(
+                         ready_to_run_namespaces.first));
+    }
 
-    // If there is more work available, wake up worker thread.
-    if (!ready_to_run_namespaces_.empty())
-      has_ready_to_run_tasks_cv_.Signal();
+    // If there is more work available, wake up worker threads.
+    WakeUpIdleWorkers(nullptr);
   }
 }
 
@@ -327,9 +397,11 @@ void TaskGraphRunner::Shutdown() {
   DCHECK(!shutdown_);
   shutdown_ = true;
 
-  // Wake up a worker so it knows it should exit. This will cause all workers
-  // to exit as each will wake up another worker before exiting.
-  has_ready_to_run_tasks_cv_.Signal();
+  // Wake up idle workers so they know they should exit. Busy workers will
+  // notice once they are done with their current task.
+  for (Worker* worker : idle_workers_)
+    worker->wake_up_cv.Signal();
+  idle_workers_.clear();
 }
 
 void TaskGraphRunner::FlushForTesting() {
@@ -345,69 +417,115 @@ void TaskGraphRunner::FlushForTesting() {
 }
 
 void TaskGraphRunner::Run() {
+  RunTasksForCategories(std::vector<uint16_t>());
+}
+
+void TaskGraphRunner::RunTasksForCategories(
+    const std::vector<uint16_t>& categories) {
   base::AutoLock lock(lock_);
 
+  Worker worker(&lock_, categories);
   while (true) {
-    if (ready_to_run_namespaces_.empty()) {
+    uint16_t category;
+    if (!GetCategoryToRun(&worker, &category)) {
       // Exit when shutdown is set and no more tasks are pending.
       if (shutdown_)
         break;
 
       // Wait for more tasks.
-      has_ready_to_run_tasks_cv_.Wait();
+      idle_workers_.push_back(&worker);
+      worker.wake_up_cv.Wait();
+
+      // Whoever woke us up already removed us, unless the wake up was
+      // spurious.
+      idle_workers_.erase(
+          std::remove(idle_workers_.begin(), idle_workers_.end(), &worker),
+          idle_workers_.end());
       continue;
     }
 
-    RunTaskWithLockAcquired();
+    RunTaskWithLockAcquired(category, &worker);
   }
-
-  // We noticed we should exit. Wake up the next worker so it knows it should
-  // exit as well (because the Shutdown() code only signals once).
-  has_ready_to_run_tasks_cv_.Signal();
 }
 
 void TaskGraphRunner::RunUntilIdle() {
   base::AutoLock lock(lock_);
 
-  while (!ready_to_run_namespaces_.empty())
-    RunTaskWithLockAcquired();
+  uint16_t category;
+  while (GetCategoryToRun(nullptr, &category))
+    RunTaskWithLockAcquired(category, nullptr);
+}
+
+bool TaskGraphRunner::GetCategoryToRun(const Worker* worker,
+                                       uint16_t* category) const {
+  lock_.AssertAcquired();
+
+  if (ready_to_run_namespaces_.empty())
+    return false;
+
+  if (!worker || worker->categories.empty()) {
+    *category = ready_to_run_namespaces_.begin()->first;
+    return true;
+  }
+
+  for (uint16_t worker_category : worker->categories) {
+    if (ready_to_run_namespaces_.count(worker_category)) {
+      *category = worker_category;
+      return true;
+    }
+  }
+  return false;
 }
 
-void TaskGraphRunner::RunTaskWithLockAcquired() {
-  TRACE_EVENT0("toplevel", "TaskGraphRunner::RunTask");
+void TaskGraphRunner::RunTaskWithLockAcquired(uint16_t category,
+                                              Worker* worker) {
+  TRACE_EVENT1("toplevel", "TaskGraphRunner::RunTask", "category", category);
 
   lock_.AssertAcquired();
-  DCHECK(!ready_to_run_namespaces_.empty());
+  DCHECK(!worker || worker->CanRun(category));
 
-  // Take top priority TaskNamespace from |ready_to_run_namespaces_|.
-  std::pop_heap(ready_to_run_namespaces_.begin(),
-                ready_to_run_namespaces_.end(),
-                CompareTaskNamespacePriority);
-  TaskNamespace* task_namespace = ready_to_run_namespaces_.back();
-  ready_to_run_namespaces_.pop_back();
-  DCHECK(!task_namespace->ready_to_run_tasks.empty());
+  TaskNamespaceVectorMap::iterator namespaces_it =
+      ready_to_run_namespaces_.find(category);
+  DCHECK(namespaces_it != ready_to_run_namespaces_.end());
+  TaskNamespace::Vector& ready_to_run_namespaces = namespaces_it->second;
+  DCHECK(!ready_to_run_namespaces.empty());
+
+  // Take top priority TaskNamespace from |ready_to_run_namespaces|.
+  std::pop_heap(ready_to_run_namespaces.begin(),
+                ready_to_run_namespaces.end(),
+                CompareTaskNamespacePriority(category));
+  TaskNamespace* task_namespace = ready_to_run_namespaces.back();
+  ready_to_run_namespaces.pop_back();
 
   // Take top priority task from |ready_to_run_tasks|.
-  std::pop_heap(task_namespace->ready_to_run_tasks.begin(),
-                task_namespace->ready_to_run_tasks.end(),
+  PrioritizedTaskMap::iterator tasks_it =
+      task_namespace->ready_to_run_tasks.find(category);
+  DCHECK(tasks_it != task_namespace->ready_to_run_tasks.end());
+  PrioritizedTask::Vector& ready_to_run_tasks = tasks_it->second;
+  DCHECK(!ready_to_run_tasks.empty());
+  std::pop_heap(ready_to_run_tasks.begin(), ready_to_run_tasks.end(),
                 CompareTaskPriority);
-  scoped_refptr<Task> task(task_namespace->ready_to_run_tasks.back().task);
-  task_namespace->ready_to_run_tasks.pop_back();
+  scoped_refptr<Task> task(ready_to_run_tasks.back().task);
+  ready_to_run_tasks.pop_back();
 
-  // Add task namespace back to |ready_to_run_namespaces_| if not empty after
+  // Add task namespace back to |ready_to_run_namespaces| if not empty after
   // taking top priority task.
-  if (!task_namespace->ready_to_run_tasks.empty()) {
-    ready_to_run_namespaces_.push_back(task_namespace);
-    std::push_heap(ready_to_run_namespaces_.begin(),
-                   ready_to_run_namespaces_.end(),
-                   CompareTaskNamespacePriority);
+  if (!ready_to_run_tasks.empty()) {
+    ready_to_run_namespaces.push_back(task_namespace);
+    std::push_heap(ready_to_run_namespaces.begin(),
+                   ready_to_run_namespaces.end(),
+                   CompareTaskNamespacePriority(category));
+  } else {
+    task_namespace->ready_to_run_tasks.erase(tasks_it);
   }
+  if (ready_to_run_namespaces.empty())
+    ready_to_run_namespaces_.erase(namespaces_it);
 
   // Add task to |running_tasks|.
   task_namespace->running_tasks.push_back(task.get());
 
-  // There may be more work available, so wake up another worker thread.
-  has_ready_to_run_tasks_cv_.Signal();
+  // There may be more work available, so wake up other worker threads.
+  WakeUpIdleWorkers(nullptr);
 
   // Call WillRun() before releasing |lock_| and running task.
   task->WillRun();
@@ -430,41 +548,61 @@ void TaskGraphRunner::RunTaskWithLockAcquired() {
   task_namespace->running_tasks.pop_back();
 
   // Now iterate over all dependents to decrement dependencies and check if they
-  // are ready to run.
-  bool ready_to_run_namespaces_has_heap_properties = true;
-  for (DependentIterator it(&task_namespace->graph, task.get()); it; ++it) {
+  // are ready to run. The categories of the tasks that became ready need their
+  // |ready_to_run_namespaces_| heap rebuilt.
+  std::vector<uint16_t> categories_without_heap_properties;
+  for (DependentIterator it(&task_namespace->graph,
+                            task_namespace->node_indices, task.get());
+       it; ++it) {
     TaskGraph::Node& dependent_node = *it;
 
     DCHECK_LT(0u, dependent_node.dependencies);
     dependent_node.dependencies--;
-    // Task is ready if it has no dependencies. Add it to |ready_to_run_tasks_|.
+    // Task is ready if it has no dependencies. Add it to |ready_to_run_tasks|.
     if (!dependent_node.dependencies) {
-      bool was_empty = task_namespace->ready_to_run_tasks.empty();
-      task_namespace->ready_to_run_tasks.push_back(
+      PrioritizedTask::Vector& dependent_ready_to_run_tasks =
+          task_namespace->ready_to_run_tasks[dependent_node.category];
+      bool was_empty = dependent_ready_to_run_tasks.empty();
+      dependent_ready_to_run_tasks.push_back(
           PrioritizedTask(dependent_node.task, dependent_node.priority));
-      std::push_heap(task_namespace->ready_to_run_tasks.begin(),
-                     task_namespace->ready_to_run_tasks.end(),
-                     CompareTaskPriority);
-      // Task namespace is ready if it has at least one ready to run task. Add
-      // it to |ready_to_run_namespaces_| if it just become ready.
+      std::push_heap(dependent_ready_to_run_tasks.begin(),
+                     dependent_ready_to_run_tasks.end(), CompareTaskPriority);
+      // Task namespace is ready if it has at least one ready to run task in
+      // the category. Add it to |ready_to_run_namespaces_| if it just become
+      // ready.
+      TaskNamespace::Vector& dependent_ready_to_run_namespaces =
+          ready_to_run_namespaces_[dependent_node.category];
       if (was_empty) {
-        DCHECK(std::find(ready_to_run_namespaces_.begin(),
-                         ready_to_run_namespaces_.end(),
-                         task_namespace) == ready_to_run_namespaces_.end());
-        ready_to_run_namespaces_.push_back(task_namespace);
+        DCHECK(std::find(dependent_ready_to_run_namespaces.begin(),
+                         dependent_ready_to_run_namespaces.end(),
+                         task_namespace) ==
+               dependent_ready_to_run_namespaces.end());
+        dependent_ready_to_run_namespaces.push_back(task_namespace);
+      }
+      if (std::find(categories_without_heap_properties.begin(),
+                    categories_without_heap_properties.end(),
+                    dependent_node.category) ==
+          categories_without_heap_properties.end()) {
+        categories_without_heap_properties.push_back(dependent_node.category);
       }
-      ready_to_run_namespaces_has_heap_properties = false;
     }
   }
 
   // Rearrange the task namespaces in |ready_to_run_namespaces_| in such a way
-  // that they yet again form a heap.
-  if (!ready_to_run_namespaces_has_heap_properties) {
-    std::make_heap(ready_to_run_namespaces_.begin(),
-                   ready_to_run_namespaces_.end(),
-                   CompareTaskNamespacePriority);
+  // that they yet again form heaps.
+  for (uint16_t dependent_category : categories_without_heap_properties) {
+    TaskNamespace::Vector& dependent_ready_to_run_namespaces =
+        ready_to_run_namespaces_[dependent_category];
+    std::make_heap(dependent_ready_to_run_namespaces.begin(),
+                   dependent_ready_to_run_namespaces.end(),
+                   CompareTaskNamespacePriority(dependent_category));
   }
 
+  // This worker picks up the tasks it can run itself, but others have to be
+  // woken up for the rest.
+  if (!categories_without_heap_properties.empty())
+    WakeUpIdleWorkers(worker);
+
   // Finally add task to |completed_tasks_|.
   task_namespace->completed_tasks.push_back(task);
 
@@ -473,4 +611,25 @@ void TaskGraphRunner::RunTaskWithLockAcquired() {
     has_namespaces_with_finished_running_tasks_cv_.Signal();
 }
 
+void TaskGraphRunner::WakeUpIdleWorkers(const Worker* current_worker) {
+  lock_.AssertAcquired();
+
+  for (const auto& ready_to_run_namespaces : ready_to_run_namespaces_) {
+    uint16_t category = ready_to_run_namespaces.first;
+    if (current_worker && current_worker->CanRun(category))
+      continue;
+
+    std::vector<Worker*>::iterator it =
+        std::find_if(idle_workers_.begin(), idle_workers_.end(),
+                     [category](const Worker* worker) {
+                       return worker->CanRun(category);
+                     });
+    if (it == idle_workers_.end())
+      continue;
+
+    (*it)->wake_up_cv.Signal();
+    idle_workers_.erase(it);
+  }
+}
+
 }  // namespace cc
@@ -5,12 +5,16 @@
 #ifndef CC_RASTER_TASK_GRAPH_RUNNER_H_
 #define CC_RASTER_TASK_GRAPH_RUNNER_H_
 
+#include <stdint.h>
+
 #include <map>
+#include <utility>
 #include <vector>
 
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
 #include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
 #include "cc/base/cc_export.h"
 
 namespace cc {
@@ -36,9 +40,11 @@ class CC_EXPORT Task : public base::RefCountedThreadSafe<Task> {
 };
 
 // Dependencies are represented as edges in a task graph. Each graph node is
-// assigned a priority and a run count that matches the number of dependencies.
-// Priority range from 0 (most favorable scheduling) to UINT_MAX (least
-// favorable).
+// assigned a category, a priority and a run count that matches the number of
+// dependencies. Priority range from 0 (most favorable scheduling) to UINT_MAX
+// (least favorable). Categories are defined by the client and let workers be
+// dedicated to some kinds of tasks, see
+// TaskGraphRunner::RunTasksForCategories(). Category 0 is the default.
 struct CC_EXPORT TaskGraph {
   struct Node {
     class TaskComparator {
@@ -54,9 +60,18 @@ struct CC_EXPORT TaskGraph {
     typedef std::vector<Node> Vector;
 
     Node(Task* task, size_t priority, size_t dependencies)
-        : task(task), priority(priority), dependencies(dependencies) {}
+        : task(task),
+          category(0),
+          priority(priority),
+          dependencies(dependencies) {}
+    Node(Task* task, uint16_t category, size_t priority, size_t dependencies)
+        : task(task),
+          category(category),
+          priority(priority),
+          dependencies(dependencies) {}
 
     Task* task;
+    uint16_t category;
     size_t priority;
     size_t dependencies;
   };
@@ -125,9 +140,15 @@ class CC_EXPORT TaskGraphRunner {
   void CollectCompletedTasks(NamespaceToken token,
                              Task::Vector* completed_tasks);
 
-  // Run tasks until Shutdown() is called.
+  // Run tasks of any category until Shutdown() is called. Lower categories
+  // are run first.
   void Run();
 
+  // Like Run(), but only runs tasks in |categories|, preferring the ones that
+  // come first. This is used to dedicate worker threads to some kinds of
+  // work. An empty |categories| runs tasks of any category.
+  void RunTasksForCategories(const std::vector<uint16_t>& categories);
+
   // Process all pending tasks, but don't wait/sleep. Return as soon as all
   // tasks that can be run are taken care of.
   void RunUntilIdle();
@@ -153,17 +174,32 @@ class CC_EXPORT TaskGraphRunner {
 
   typedef std::vector<const Task*> TaskVector;
 
+  // Maps a task to the index of its node in a task graph. Sorted by task, so
+  // that lookups are binary searches in one allocation.
+  typedef std::vector<std::pair<const Task*, size_t>> NodeIndex;
+
+  // Ordered sets of ready to run tasks, keyed by category. Categories without
+  // ready to run tasks are not present.
+  typedef std::map<uint16_t, PrioritizedTask::Vector> PrioritizedTaskMap;
+
+  // A thread in RunTasksForCategories().
+  struct Worker;
+
   struct TaskNamespace {
     typedef std::vector<TaskNamespace*> Vector;
 
     TaskNamespace();
     ~TaskNamespace();
 
-    // Current task graph.
+    // Current task graph. Its edges are sorted by task.
     TaskGraph graph;
 
-    // Ordered set of tasks that are ready to run.
-    PrioritizedTask::Vector ready_to_run_tasks;
+    // Index of the nodes of |graph|, used to find dependents without
+    // searching the graph.
+    NodeIndex node_indices;
+
+    // Ordered sets of tasks that are ready to run.
+    PrioritizedTaskMap ready_to_run_tasks;
 
     // Completed tasks not yet collected by origin thread.
     Task::Vector completed_tasks;
@@ -174,23 +210,35 @@ class CC_EXPORT TaskGraphRunner {
 
   typedef std::map<int, TaskNamespace> TaskNamespaceMap;
 
+  // Ordered sets of task namespaces with ready to run tasks, keyed by
+  // category. Categories without ready to run tasks are not present.
+  typedef std::map<uint16_t, TaskNamespace::Vector> TaskNamespaceVectorMap;
+
   static bool CompareTaskPriority(const PrioritizedTask& a,
                                   const PrioritizedTask& b) {
     // In this system, numerically lower priority is run first.
     return a.priority > b.priority;
   }
 
-  static bool CompareTaskNamespacePriority(const TaskNamespace* a,
-                                           const TaskNamespace* b) {
-    DCHECK(!a->ready_to_run_tasks.empty());
-    DCHECK(!b->ready_to_run_tasks.empty());
-
-    // Compare based on task priority of the ready_to_run_tasks heap .front()
-    // will hold the max element of the heap, except after pop_heap, when max
-    // element is moved to .back().
-    return CompareTaskPriority(a->ready_to_run_tasks.front(),
-                               b->ready_to_run_tasks.front());
-  }
+  // Orders task namespaces by the priority of their top ready to run task in
+  // |category|.
+  class CompareTaskNamespacePriority {
+   public:
+    explicit CompareTaskNamespacePriority(uint16_t category)
+        : category_(category) {}
+
+    bool operator()(const TaskNamespace* a, const TaskNamespace* b) const {
+      // Compare based on task priority of the ready_to_run_tasks heap
+      // .front() will hold the max element of the heap, except after
+      // pop_heap, when max element is moved to .back().
+      return CompareTaskPriority(
+          a->ready_to_run_tasks.find(category_)->second.front(),
+          b->ready_to_run_tasks.find(category_)->second.front());
+    }
+
+   private:
+    uint16_t category_;
+  };
 
   static bool HasFinishedRunningTasksInNamespace(
       const TaskNamespace* task_namespace) {
@@ -198,18 +246,26 @@ class CC_EXPORT TaskGraphRunner {
            task_namespace->ready_to_run_tasks.empty();
   }
 
-  // Run next task. Caller must acquire |lock_| prior to calling this function
-  // and make sure at least one task is ready to run.
-  void RunTaskWithLockAcquired();
+  // Finds the category that |worker| should run a task from next, or any
+  // category with ready to run tasks if |worker| is null. Returns false if
+  // there is no such task. Caller must acquire |lock_|.
+  bool GetCategoryToRun(const Worker* worker, uint16_t* category) const;
+
+  // Run next task in |category| on behalf of |worker|, which is null when
+  // called from RunUntilIdle(). Caller must acquire |lock_| prior to calling
+  // this function and make sure at least one task in |category| is ready to
+  // run.
+  void RunTaskWithLockAcquired(uint16_t category, Worker* worker);
+
+  // Wakes up one idle worker for each category with ready to run tasks,
+  // skipping categories that |current_worker| can run itself. Caller must
+  // acquire |lock_|.
+  void WakeUpIdleWorkers(const Worker* current_worker);
 
   // This lock protects all members of this class. Do not read or modify
   // anything without holding this lock. Do not block while holding this lock.
   mutable base::Lock lock_;
 
-  // Condition variable that is waited on by Run() until new tasks are ready to
-  // run or shutdown starts.
-  base::ConditionVariable has_ready_to_run_tasks_cv_;
-
   // Condition variable that is waited on by origin threads until a namespace
   // has finished running all associated tasks.
   base::ConditionVariable has_namespaces_with_finished_running_tasks_cv_;
@@ -221,8 +277,12 @@ class CC_EXPORT TaskGraphRunner {
   // not yet collected.
   TaskNamespaceMap namespaces_;
 
-  // Ordered set of task namespaces that have ready to run tasks.
-  TaskNamespace::Vector ready_to_run_namespaces_;
+  // Ordered sets of task namespaces that have ready to run tasks.
+  TaskNamespaceVectorMap ready_to_run_namespaces_;
+
+  // Workers waiting for tasks. A worker is removed when it is woken up, so
+  // that each wake up is sent to a different worker.
+  std::vector<Worker*> idle_workers_;
 
   // Set during shutdown. Tells Run() to return when no more tasks are pending.
   bool shutdown_;
@@ -6,6 +6,7 @@
 
 #include "base/metrics/histogram.h"
 #include "base/trace_event/trace_event.h"
+#include "cc/debug/benchmark_instrumentation.h"
 #include "cc/debug/rendering_stats_instrumentation.h"
 
 namespace cc {
@@ -38,6 +39,11 @@ class CompositorTimingHistory::UMAReporter {
   virtual void AddDrawDuration(base::TimeDelta duration,
                                base::TimeDelta estimate,
                                bool affects_estimate) = 0;
+
+  // These stages are not estimated.
+  virtual void AddInputToBeginImplFrameDuration(base::TimeDelta duration) = 0;
+  virtual void AddCommitDuration(base::TimeDelta duration) = 0;
+  virtual void AddSwapDuration(base::TimeDelta duration) = 0;
 };
 
 namespace {
@@ -179,6 +185,21 @@ class RendererUMAReporter : public CompositorTimingHistory::UMAReporter {
     REPORT_COMPOSITOR_TIMING_HISTORY_UMA("Renderer", "Draw");
     DeprecatedDrawDurationUMA(duration, estimate);
   }
+
+  void AddInputToBeginImplFrameDuration(base::TimeDelta duration) override {
+    UMA_HISTOGRAM_CUSTOM_TIMES_MICROS(
+        "Scheduling.Renderer.InputToBeginImplFrameDuration", duration);
+  }
+
+  void AddCommitDuration(base::TimeDelta duration) override {
+    UMA_HISTOGRAM_CUSTOM_TIMES_MICROS("Scheduling.Renderer.CommitDuration",
+                                      duration);
+  }
+
+  void AddSwapDuration(base::TimeDelta duration) override {
+    UMA_HISTOGRAM_CUSTOM_TIMES_MICROS("Scheduling.Renderer.SwapDuration",
+                                      duration);
+  }
 };
 
 class BrowserUMAReporter : public CompositorTimingHistory::UMAReporter {
@@ -235,6 +256,21 @@ class BrowserUMAReporter : public CompositorTimingHistory::UMAReporter {
     REPORT_COMPOSITOR_TIMING_HISTORY_UMA("Browser", "Draw");
     DeprecatedDrawDurationUMA(duration, estimate);
   }
+
+  void AddInputToBeginImplFrameDuration(base::TimeDelta duration) override {
+    UMA_HISTOGRAM_CUSTOM_TIMES_MICROS(
+        "Scheduling.Browser.InputToBeginImplFrameDuration", duration);
+  }
+
+  void AddCommitDuration(base::TimeDelta duration) override {
+    UMA_HISTOGRAM_CUSTOM_TIMES_MICROS("Scheduling.Browser.CommitDuration",
+                                      duration);
+  }
+
+  void AddSwapDuration(base::TimeDelta duration) override {
+    UMA_HISTOGRAM_CUSTOM_TIMES_MICROS("Scheduling.Browser.SwapDuration",
+                                      duration);
+  }
 };
 
 class NullUMAReporter : public CompositorTimingHistory::UMAReporter {
@@ -263,6 +299,9 @@ class NullUMAReporter : public CompositorTimingHistory::UMAReporter {
   void AddDrawDuration(base::TimeDelta duration,
                        base::TimeDelta estimate,
                        bool affects_estimate) override {}
+  void AddInputToBeginImplFrameDuration(base::TimeDelta duration) override {}
+  void AddCommitDuration(base::TimeDelta duration) override {}
+  void AddSwapDuration(base::TimeDelta duration) override {}
 };
 
 }  // namespace
@@ -370,10 +409,27 @@ base::TimeDelta CompositorTimingHistory::DrawDurationEstimate() const {
   return draw_duration_history_.Percentile(kDrawEstimationPercentile);
 }
 
+void CompositorTimingHistory::WillBeginImplFrame(base::TimeTicks frame_time) {
+  impl_frame_stage_timings_ = FrameStageTimings();
+  impl_frame_stage_timings_.frame_time = frame_time;
+
+  base::TimeTicks input_time =
+      rendering_stats_instrumentation_->TakeFirstPendingInputTime();
+  if (input_time.is_null())
+    return;
+
+  base::TimeDelta input_to_begin_frame_duration = Now() - input_time;
+  impl_frame_stage_timings_.input_to_begin_frame =
+      input_to_begin_frame_duration;
+  uma_reporter_->AddInputToBeginImplFrameDuration(
+      input_to_begin_frame_duration);
+}
+
 void CompositorTimingHistory::WillBeginMainFrame(bool on_critical_path) {
   DCHECK_EQ(base::TimeTicks(), begin_main_frame_sent_time_);
   begin_main_frame_on_critical_path_ = on_critical_path;
   begin_main_frame_sent_time_ = Now();
+  main_frame_stage_timings_ = FrameStageTimings();
 }
 
 void CompositorTimingHistory::BeginMainFrameStarted(
@@ -387,11 +443,28 @@ void CompositorTimingHistory::BeginMainFrameAborted() {
   DidCommit();
 }
 
+void CompositorTimingHistory::WillCommit() {
+  DCHECK_NE(base::TimeTicks(), begin_main_frame_sent_time_);
+  start_commit_time_ = Now();
+  main_frame_stage_timings_.main_thread =
+      start_commit_time_ - begin_main_frame_sent_time_;
+}
+
 void CompositorTimingHistory::DidCommit() {
   DCHECK_NE(base::TimeTicks(), begin_main_frame_sent_time_);
 
   commit_time_ = Now();
 
+  // An aborted BeginMainFrame never starts a commit, and has no stage timings
+  // of its own.
+  if (!start_commit_time_.is_null()) {
+    base::TimeDelta commit_duration = commit_time_ - start_commit_time_;
+    main_frame_stage_timings_.has_main_frame = true;
+    main_frame_stage_timings_.commit = commit_duration;
+    uma_reporter_->AddCommitDuration(commit_duration);
+    start_commit_time_ = base::TimeTicks();
+  }
+
   // If the BeginMainFrame start time isn't know, assume it was immediate
   // for scheduling purposes, but don't report it for UMA to avoid skewing
   // the results.
@@ -491,6 +564,8 @@ void CompositorTimingHistory::ReadyToActivate() {
         time_since_commit);
   }
 
+  main_frame_stage_timings_.raster = time_since_commit;
+
   commit_time_ = base::TimeTicks();
 }
 
@@ -508,6 +583,12 @@ void CompositorTimingHistory::DidActivate() {
   if (enabled_)
     activate_duration_history_.InsertSample(activate_duration);
 
+  if (main_frame_stage_timings_.has_main_frame) {
+    main_frame_stage_timings_.activation = activate_duration;
+    activated_main_frame_stage_timings_ = main_frame_stage_timings_;
+    main_frame_stage_timings_ = FrameStageTimings();
+  }
+
   start_activate_time_ = base::TimeTicks();
 }
 
@@ -533,7 +614,56 @@ void CompositorTimingHistory::DidDraw() {
     draw_duration_history_.InsertSample(draw_duration);
   }
 
+  FrameStageTimings timings = impl_frame_stage_timings_;
+  if (activated_main_frame_stage_timings_.has_main_frame) {
+    const FrameStageTimings& main_frame = activated_main_frame_stage_timings_;
+    timings.has_main_frame = true;
+    timings.main_thread = main_frame.main_thread;
+    timings.commit = main_frame.commit;
+    timings.raster = main_frame.raster;
+    timings.activation = main_frame.activation;
+    activated_main_frame_stage_timings_ = FrameStageTimings();
+  }
+  timings.draw = draw_duration;
+
+  // The frame is finished once its swap, if any, completes.
+  if (swap_time_.is_null())
+    DidFinishFrame(timings);
+  else
+    pending_swaps_.push_back(std::make_pair(swap_time_, timings));
+
   start_draw_time_ = base::TimeTicks();
+  swap_time_ = base::TimeTicks();
+}
+
+void CompositorTimingHistory::DidSwapBuffers() {
+  // Swaps are only attributed to the frame being drawn.
+  if (start_draw_time_.is_null())
+    return;
+  swap_time_ = Now();
+}
+
+void CompositorTimingHistory::DidSwapBuffersComplete() {
+  if (pending_swaps_.empty())
+    return;
+
+  base::TimeDelta swap_duration = Now() - pending_swaps_.front().first;
+  FrameStageTimings timings = pending_swaps_.front().second;
+  pending_swaps_.pop_front();
+
+  timings.swap = swap_duration;
+  uma_reporter_->AddSwapDuration(swap_duration);
+  DidFinishFrame(timings);
+}
+
+void CompositorTimingHistory::DidLoseOutputSurface() {
+  // The swaps of a lost output surface never complete.
+  pending_swaps_.clear();
+}
+
+void CompositorTimingHistory::DidFinishFrame(const FrameStageTimings& timings) {
+  benchmark_instrumentation::IssueFrameStageTimingsEvent(timings);
+  rendering_stats_instrumentation_->AddFrameStageTimings(timings);
 }
 
 }  // namespace cc
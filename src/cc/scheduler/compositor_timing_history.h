@@ -5,8 +5,12 @@
 #ifndef CC_SCHEDULER_COMPOSITOR_TIMING_HISTORY_H_
 #define CC_SCHEDULER_COMPOSITOR_TIMING_HISTORY_H_
 
+#include <deque>
+#include <utility>
+
 #include "base/memory/scoped_ptr.h"
 #include "cc/base/rolling_time_delta_history.h"
+#include "cc/debug/rendering_stats.h"
 
 namespace base {
 namespace trace_event {
@@ -50,9 +54,11 @@ class CC_EXPORT CompositorTimingHistory {
 
   void SetRecordingEnabled(bool enabled);
 
+  void WillBeginImplFrame(base::TimeTicks frame_time);
   void WillBeginMainFrame(bool on_critical_path);
   void BeginMainFrameStarted(base::TimeTicks main_thread_start_time);
   void BeginMainFrameAborted();
+  void WillCommit();
   void DidCommit();
   void WillPrepareTiles();
   void DidPrepareTiles();
@@ -61,6 +67,9 @@ class CC_EXPORT CompositorTimingHistory {
   void DidActivate();
   void WillDraw();
   void DidDraw();
+  void DidSwapBuffers();
+  void DidSwapBuffersComplete();
+  void DidLoseOutputSurface();
 
  protected:
   static scoped_ptr<UMAReporter> CreateUMAReporter(UMACategory category);
@@ -80,15 +89,29 @@ class CC_EXPORT CompositorTimingHistory {
   bool begin_main_frame_on_critical_path_;
   base::TimeTicks begin_main_frame_sent_time_;
   base::TimeTicks begin_main_frame_start_time_;
+  base::TimeTicks start_commit_time_;
   base::TimeTicks commit_time_;
   base::TimeTicks start_prepare_tiles_time_;
   base::TimeTicks start_activate_time_;
   base::TimeTicks start_draw_time_;
+  base::TimeTicks swap_time_;
+
+  // Per-frame stage timings, which are assembled as the frame moves through
+  // the pipeline: the impl frame being drawn, the main frame between its
+  // BeginMainFrame and its activation, and the last activated main frame,
+  // which is attributed to the next draw.
+  FrameStageTimings impl_frame_stage_timings_;
+  FrameStageTimings main_frame_stage_timings_;
+  FrameStageTimings activated_main_frame_stage_timings_;
+  // Drawn frames waiting for their swap to complete, with their swap times.
+  std::deque<std::pair<base::TimeTicks, FrameStageTimings>> pending_swaps_;
 
   scoped_ptr<UMAReporter> uma_reporter_;
   RenderingStatsInstrumentation* rendering_stats_instrumentation_;
 
  private:
+  void DidFinishFrame(const FrameStageTimings& timings);
+
   DISALLOW_COPY_AND_ASSIGN(CompositorTimingHistory);
 };
 
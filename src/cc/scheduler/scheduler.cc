@@ -198,6 +198,7 @@ void Scheduler::SetMaxSwapsPending(int max) {
 }
 
 void Scheduler::DidSwapBuffers() {
+  compositor_timing_history_->DidSwapBuffers();
   state_machine_.DidSwapBuffers();
 
   // There is no need to call ProcessScheduledActions here because
@@ -209,6 +210,7 @@ void Scheduler::DidSwapBuffers() {
 
 void Scheduler::DidSwapBuffersComplete() {
   DCHECK_GT(state_machine_.pending_swaps(), 0) << AsValue()->ToString();
+  compositor_timing_history_->DidSwapBuffersComplete();
   state_machine_.DidSwapBuffersComplete();
   ProcessScheduledActions();
 }
@@ -249,6 +251,7 @@ void Scheduler::DidLoseOutputSurface() {
   TRACE_EVENT0("cc", "Scheduler::DidLoseOutputSurface");
   begin_retro_frame_args_.clear();
   begin_retro_frame_task_.Cancel();
+  compositor_timing_history_->DidLoseOutputSurface();
   state_machine_.DidLoseOutputSurface();
   UpdateCompositorTimingHistoryRecordingEnabled();
   ProcessScheduledActions();
@@ -513,6 +516,7 @@ void Scheduler::BeginImplFrame(const BeginFrameArgs& args) {
 
   begin_impl_frame_tracker_.Start(args);
   begin_main_frame_args_ = args;
+  compositor_timing_history_->WillBeginImplFrame(args.frame_time);
   state_machine_.OnBeginImplFrame();
   devtools_instrumentation::DidBeginFrame(layer_tree_host_id_);
   client_->WillBeginImplFrame(begin_impl_frame_tracker_.Current());
@@ -665,6 +669,7 @@ void Scheduler::ProcessScheduledActions() {
                 "461509 Scheduler::ProcessScheduledActions4"));
         bool commit_has_no_updates = false;
         state_machine_.WillCommit(commit_has_no_updates);
+        compositor_timing_history_->WillCommit();
         client_->ScheduledActionCommit();
         break;
       }
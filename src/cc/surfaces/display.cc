@@ -37,7 +37,8 @@ Display::Display(DisplayClient* client,
       device_scale_factor_(1.f),
       swapped_since_resize_(false),
       scheduler_(nullptr),
-      texture_mailbox_deleter_(new TextureMailboxDeleter(nullptr)) {
+      texture_mailbox_deleter_(new TextureMailboxDeleter(nullptr)),
+      task_graph_runner_(nullptr) {
   manager_->AddObserver(this);
 }
 
@@ -98,6 +99,11 @@ void Display::SetExternalClip(const gfx::Rect& clip) {
   external_clip_ = clip;
 }
 
+void Display::SetTaskGraphRunner(TaskGraphRunner* task_graph_runner) {
+  DCHECK(!renderer_);
+  task_graph_runner_ = task_graph_runner;
+}
+
 void Display::InitializeRenderer() {
   if (resource_provider_)
     return;
@@ -124,6 +130,8 @@ void Display::InitializeRenderer() {
         this, &settings_, output_surface_.get(), resource_provider.get());
     if (!renderer)
       return;
+    if (task_graph_runner_)
+      renderer->SetTaskGraphRunner(task_graph_runner_);
     renderer_ = renderer.Pass();
   }
 
@@ -176,6 +184,10 @@ void Display::RemoveSurface(Surface* surface) {
       scheduler_->begin_frame_source_for_children());
 }
 
+bool Display::HasCachedRenderPass(RenderPassId id) const {
+  return renderer_ && renderer_->HasCachedRenderPass(id);
+}
+
 bool Display::DrawAndSwap() {
   TRACE_EVENT0("cc", "Display::DrawAndSwap");
 
@@ -40,6 +40,7 @@ class Surface;
 class SurfaceAggregator;
 class SurfaceIdAllocator;
 class SurfaceFactory;
+class TaskGraphRunner;
 class TextureMailboxDeleter;
 
 // A Display produces a surface that can be used to draw to a physical display
@@ -67,11 +68,17 @@ class CC_SURFACES_EXPORT Display : public DisplaySchedulerClient,
   void Resize(const gfx::Size& new_size);
   void SetExternalClip(const gfx::Rect& clip);
 
+  // Lets a software renderer draw in parallel bands on the workers of
+  // |task_graph_runner|, see SoftwareRenderer::SetTaskGraphRunner(). Must be
+  // called before the renderer is created and outlive the Display.
+  void SetTaskGraphRunner(TaskGraphRunner* task_graph_runner);
+
   SurfaceId CurrentSurfaceId();
 
   // SurfaceAggregatorClient implementation
   void AddSurface(Surface* surface) override;
   void RemoveSurface(Surface* surface) override;
+  bool HasCachedRenderPass(RenderPassId id) const override;
 
   // DisplaySchedulerClient implementation.
   bool DrawAndSwap() override;
@@ -121,6 +128,7 @@ class CC_SURFACES_EXPORT Display : public DisplaySchedulerClient,
   scoped_ptr<SurfaceAggregator> aggregator_;
   scoped_ptr<DirectRenderer> renderer_;
   scoped_ptr<TextureMailboxDeleter> texture_mailbox_deleter_;
+  TaskGraphRunner* task_graph_runner_;
   std::vector<ui::LatencyInfo> stored_latency_info_;
 
   DISALLOW_COPY_AND_ASSIGN(Display);
@@ -39,8 +39,54 @@ void MoveMatchingRequests(
   copy_requests->erase(request_range.first, request_range.second);
 }
 
+// Frame indices recorded for surfaces that weren't aggregated.
+const int kNoSurfaceFrameIndex = -1;
+const int kCycleFrameIndex = -2;
+
+// Upper bound on the contents the renderer keeps for the passes of cached
+// surfaces in one frame.
+const size_t kMaxCachedSurfaceBytes = 32 * 1024 * 1024;
+
+// The size of a pass' contents, at four bytes per pixel.
+size_t CachedBytesForPass(const RenderPass& pass) {
+  return static_cast<size_t>(pass.output_rect.width()) *
+         pass.output_rect.height() * 4;
+}
+
+// Returns the transform to the root target of |source|, a pass of the surface
+// drawn by |surface_quad| into |dest_pass|.
+gfx::Transform TransformToRootTarget(const RenderPass& source,
+                                     const SurfaceDrawQuad* surface_quad,
+                                     const gfx::Transform& target_transform,
+                                     const RenderPass& dest_pass) {
+  // Contributing passes aggregated in to the pass list need to take the
+  // transform of the surface quad into account to update their transform to
+  // the root surface.
+  gfx::Transform transform = source.transform_to_root_target;
+  transform.ConcatTransform(
+      surface_quad->shared_quad_state->quad_to_target_transform);
+  transform.ConcatTransform(target_transform);
+  transform.ConcatTransform(dest_pass.transform_to_root_target);
+  return transform;
+}
+
 }  // namespace
 
+struct SurfaceAggregator::CachedSurface {
+  // The surface and the descendants drawn into its pass, with their frame
+  // indices.
+  std::vector<std::pair<SurfaceId, int>> surfaces;
+};
+
+struct SurfaceAggregator::PrewalkData {
+  int frame_index;
+  bool valid;
+  ResourceProvider::ResourceIdSet referenced_resources;
+  // Each pair in the vector is a child surface and the transform from its
+  // target to the root target of this surface.
+  std::vector<std::pair<SurfaceId, gfx::Transform>> child_surfaces;
+};
+
 SurfaceAggregator::SurfaceAggregator(SurfaceAggregatorClient* client,
                                      SurfaceManager* manager,
                                      ResourceProvider* provider,
@@ -49,7 +95,11 @@ SurfaceAggregator::SurfaceAggregator(SurfaceAggregatorClient* client,
       manager_(manager),
       provider_(provider),
       next_render_pass_id_(1),
-      aggregate_only_damaged_(aggregate_only_damaged) {
+      aggregate_only_damaged_(aggregate_only_damaged),
+      has_copy_requests_(false),
+      use_cached_surfaces_(false),
+      caching_surface_(false),
+      cached_bytes_(0) {
   DCHECK(manager_);
 }
 
@@ -166,11 +216,20 @@ void SurfaceAggregator::HandleSurfaceQuad(
   SurfaceId surface_id = surface_quad->surface_id;
   // If this surface's id is already in our referenced set then it creates
   // a cycle in the graph and should be dropped.
-  if (referenced_surfaces_.count(surface_id))
+  if (referenced_surfaces_.count(surface_id)) {
+    aggregated_surfaces_.push_back(
+        std::make_pair(surface_id, kCycleFrameIndex));
     return;
+  }
   Surface* surface = manager_->GetSurfaceForId(surface_id);
-  if (!surface)
+  if (!surface) {
+    aggregated_surfaces_.push_back(
+        std::make_pair(surface_id, kNoSurfaceFrameIndex));
     return;
+  }
+  size_t first_aggregated_surface = aggregated_surfaces_.size();
+  aggregated_surfaces_.push_back(
+      std::make_pair(surface_id, surface->frame_index()));
   const CompositorFrame* frame = surface->GetEligibleFrame();
   if (!frame)
     return;
@@ -190,6 +249,13 @@ void SurfaceAggregator::HandleSurfaceQuad(
     return;
   }
 
+  const RenderPass& last_pass = *render_pass_list.back();
+  if (use_cached_surfaces_ &&
+      AppendCachedSurface(surface_quad, last_pass, target_transform, clip_rect,
+                          dest_pass)) {
+    return;
+  }
+
   SurfaceSet::iterator it = referenced_surfaces_.insert(surface_id).first;
   // TODO(vmpstr): provider check is a hack for unittests that don't set up a
   // resource provider.
@@ -200,6 +266,22 @@ void SurfaceAggregator::HandleSurfaceQuad(
   bool merge_pass =
       surface_quad->shared_quad_state->opacity == 1.f && copy_requests.empty();
 
+  // A surface that had no new frame since the last aggregation is likely to
+  // be unchanged in the next one too. It is drawn into a pass of its own that
+  // the renderer keeps, so that later aggregations only add that pass.
+  bool cache_surface = false;
+  auto previous_it = previous_contained_surfaces_.find(surface_id);
+  if (use_cached_surfaces_ &&
+      previous_it != previous_contained_surfaces_.end() &&
+      previous_it->second == surface->frame_index() &&
+      cached_bytes_ + CachedBytesForPass(last_pass) <= kMaxCachedSurfaceBytes) {
+    cache_surface = true;
+    merge_pass = false;
+    cached_bytes_ += CachedBytesForPass(last_pass);
+  }
+  bool was_caching_surface = caching_surface_;
+  caching_surface_ |= cache_surface;
+
   const RenderPassList& referenced_passes = render_pass_list;
   size_t passes_to_copy =
       merge_pass ? referenced_passes.size() - 1 : referenced_passes.size();
@@ -212,21 +294,16 @@ void SurfaceAggregator::HandleSurfaceQuad(
 
     RenderPassId remapped_pass_id = RemapPassId(source.id, surface_id);
 
-    copy_pass->SetAll(remapped_pass_id, source.output_rect, gfx::Rect(),
-                      source.transform_to_root_target,
-                      source.has_transparent_background);
+    copy_pass->SetAll(
+        remapped_pass_id, source.output_rect, gfx::Rect(),
+        TransformToRootTarget(source, surface_quad, target_transform,
+                              *dest_pass),
+        source.has_transparent_background);
+    // The cached pass is only complete if the passes drawn into it are.
+    copy_pass->cache_contents = caching_surface_;
 
     MoveMatchingRequests(source.id, &copy_requests, &copy_pass->copy_requests);
 
-    // Contributing passes aggregated in to the pass list need to take the
-    // transform of the surface quad into account to update their transform to
-    // the root surface.
-    copy_pass->transform_to_root_target.ConcatTransform(
-        surface_quad->shared_quad_state->quad_to_target_transform);
-    copy_pass->transform_to_root_target.ConcatTransform(target_transform);
-    copy_pass->transform_to_root_target.ConcatTransform(
-        dest_pass->transform_to_root_target);
-
     CopyQuadsToPass(source.quad_list, source.shared_quad_state_list,
                     child_to_parent_map, gfx::Transform(), ClipData(),
                     copy_pass.get(), surface_id);
@@ -238,7 +315,6 @@ void SurfaceAggregator::HandleSurfaceQuad(
       surface_quad->shared_quad_state->quad_to_target_transform;
   surface_transform.ConcatTransform(target_transform);
 
-  const RenderPass& last_pass = *render_pass_list.back();
   if (merge_pass) {
     // TODO(jamesr): Clean up last pass special casing.
     const QuadList& quads = last_pass.quad_list;
@@ -262,26 +338,114 @@ void SurfaceAggregator::HandleSurfaceQuad(
                     dest_pass, surface_id);
   } else {
     RenderPassId remapped_pass_id = RemapPassId(last_pass.id, surface_id);
+    AppendSurfacePassQuad(surface_quad, target_transform, clip_rect,
+                          remapped_pass_id, dest_pass);
+  }
+
+  referenced_surfaces_.erase(it);
+  caching_surface_ = was_caching_surface;
+
+  if (!cache_surface || !CanCacheSurfaces(first_aggregated_surface))
+    return;
+  scoped_ptr<CachedSurface> cached_surface(new CachedSurface);
+  cached_surface->surfaces.assign(
+      aggregated_surfaces_.begin() + first_aggregated_surface,
+      aggregated_surfaces_.end());
+  cached_surfaces_.set(surface_id, cached_surface.Pass());
+}
 
-    SharedQuadState* shared_quad_state =
-        CopySharedQuadState(surface_quad->shared_quad_state, target_transform,
-                            clip_rect, dest_pass);
+bool SurfaceAggregator::AppendCachedSurface(
+    const SurfaceDrawQuad* surface_quad,
+    const RenderPass& source,
+    const gfx::Transform& target_transform,
+    const ClipData& clip_rect,
+    RenderPass* dest_pass) {
+  SurfaceId surface_id = surface_quad->surface_id;
+  CachedSurface* cached_surface = cached_surfaces_.get(surface_id);
+  if (!cached_surface)
+    return false;
+
+  RenderPassId remapped_pass_id = RemapPassId(source.id, surface_id);
+  if (!client_->HasCachedRenderPass(remapped_pass_id)) {
+    cached_surfaces_.erase(surface_id);
+    return false;
+  }
 
-    RenderPassDrawQuad* quad =
-        dest_pass->CreateAndAppendDrawQuad<RenderPassDrawQuad>();
-    quad->SetNew(shared_quad_state,
-                 surface_quad->rect,
-                 surface_quad->visible_rect,
-                 remapped_pass_id,
-                 0,
-                 gfx::Vector2dF(),
-                 gfx::Size(),
-                 FilterOperations(),
-                 gfx::Vector2dF(),
-                 FilterOperations());
+  for (const auto& cached : cached_surface->surfaces) {
+    // The surface itself isn't referenced yet, so this only finds cycles
+    // through its descendants.
+    if (referenced_surfaces_.count(cached.first))
+      return false;
+    Surface* surface = manager_->GetSurfaceForId(cached.first);
+    int frame_index = surface ? surface->frame_index() : kNoSurfaceFrameIndex;
+    if (frame_index != cached.second) {
+      cached_surfaces_.erase(surface_id);
+      return false;
+    }
   }
 
-  referenced_surfaces_.erase(it);
+  size_t bytes = CachedBytesForPass(source);
+  if (cached_bytes_ + bytes > kMaxCachedSurfaceBytes)
+    return false;
+  cached_bytes_ += bytes;
+
+  // The surface itself was recorded by the caller.
+  aggregated_surfaces_.insert(aggregated_surfaces_.end(),
+                              cached_surface->surfaces.begin() + 1,
+                              cached_surface->surfaces.end());
+
+  scoped_ptr<RenderPass> cached_pass = RenderPass::Create();
+  cached_pass->SetAll(remapped_pass_id, source.output_rect, gfx::Rect(),
+                      TransformToRootTarget(source, surface_quad,
+                                            target_transform, *dest_pass),
+                      source.has_transparent_background);
+  cached_pass->use_cached_contents = true;
+  dest_pass_list_->push_back(cached_pass.Pass());
+
+  AppendSurfacePassQuad(surface_quad, target_transform, clip_rect,
+                        remapped_pass_id, dest_pass);
+  return true;
+}
+
+void SurfaceAggregator::AppendSurfacePassQuad(
+    const SurfaceDrawQuad* surface_quad,
+    const gfx::Transform& target_transform,
+    const ClipData& clip_rect,
+    RenderPassId render_pass_id,
+    RenderPass* dest_pass) {
+  SharedQuadState* shared_quad_state =
+      CopySharedQuadState(surface_quad->shared_quad_state, target_transform,
+                          clip_rect, dest_pass);
+
+  RenderPassDrawQuad* quad =
+      dest_pass->CreateAndAppendDrawQuad<RenderPassDrawQuad>();
+  quad->SetNew(shared_quad_state,
+               surface_quad->rect,
+               surface_quad->visible_rect,
+               render_pass_id,
+               0,
+               gfx::Vector2dF(),
+               gfx::Size(),
+               FilterOperations(),
+               gfx::Vector2dF(),
+               FilterOperations());
+}
+
+bool SurfaceAggregator::CanCacheSurfaces(size_t first_surface) const {
+  for (size_t i = first_surface; i < aggregated_surfaces_.size(); ++i) {
+    const std::pair<SurfaceId, int>& aggregated = aggregated_surfaces_[i];
+    // What is dropped to break a cycle depends on where the surface is drawn.
+    if (aggregated.second == kCycleFrameIndex)
+      return false;
+    if (aggregated.second == kNoSurfaceFrameIndex)
+      continue;
+    auto it = previous_contained_surfaces_.find(aggregated.first);
+    if (it == previous_contained_surfaces_.end() ||
+        it->second != aggregated.second) {
+      return false;
+    }
+  }
+  return true;
 }
 
 SharedQuadState* SurfaceAggregator::CopySharedQuadState(
@@ -334,8 +498,10 @@ void SurfaceAggregator::CopyQuadsToPass(
   const SharedQuadState* last_copied_source_shared_quad_state = nullptr;
   const SharedQuadState* dest_shared_quad_state = nullptr;
   // If the current frame has copy requests then aggregate the entire
-  // thing, as otherwise parts of the copy requests may be ignored.
-  const bool ignore_undamaged = aggregate_only_damaged_ && !has_copy_requests_;
+  // thing, as otherwise parts of the copy requests may be ignored. The same
+  // goes for the passes of cached surfaces, which are reused whole.
+  const bool ignore_undamaged =
+      aggregate_only_damaged_ && !has_copy_requests_ && !caching_surface_;
   // Damage rect in the quad space of the current shared quad state.
   // TODO(jbauman): This rect may contain unnecessary area if
   // transform isn't axis-aligned.
@@ -378,7 +544,7 @@ void SurfaceAggregator::CopyQuadsToPass(
         dest_shared_quad_state = CopySharedQuadState(
             quad->shared_quad_state, target_transform, clip_rect, dest_pass);
         last_copied_source_shared_quad_state = quad->shared_quad_state;
-        if (aggregate_only_damaged_ && !has_copy_requests_) {
+        if (ignore_undamaged) {
           damage_rect_in_quad_space = CalculateQuadSpaceDamageRect(
               dest_shared_quad_state->quad_to_target_transform,
               dest_pass->transform_to_root_target, root_damage_rect_);
@@ -491,35 +657,11 @@ void SurfaceAggregator::ProcessAddedAndRemovedSurfaces() {
   }
 }
 
-// Walk the Surface tree from surface_id. Validate the resources of the current
-// surface and its descendants, check if there are any copy requests, and
-// return the combined damage rect.
-gfx::Rect SurfaceAggregator::PrewalkTree(SurfaceId surface_id) {
-  if (referenced_surfaces_.count(surface_id))
-    return gfx::Rect();
-  Surface* surface = manager_->GetSurfaceForId(surface_id);
-  if (!surface) {
-    contained_surfaces_[surface_id] = 0;
-    return gfx::Rect();
-  }
-  contained_surfaces_[surface_id] = surface->frame_index();
-  const CompositorFrame* surface_frame = surface->GetEligibleFrame();
-  if (!surface_frame)
-    return gfx::Rect();
-  const DelegatedFrameData* frame_data =
-      surface_frame->delegated_frame_data.get();
-  if (!frame_data)
-    return gfx::Rect();
-  int child_id = 0;
-  // TODO(jbauman): hack for unit tests that don't set up rp
-  if (provider_) {
-    child_id = ChildIdForSurface(surface);
-    if (surface->factory())
-      surface->factory()->RefResources(frame_data->resource_list);
-    provider_->ReceiveFromChild(child_id, frame_data->resource_list);
-  }
-
-  ResourceProvider::ResourceIdSet referenced_resources;
+bool SurfaceAggregator::WalkFrame(const DelegatedFrameData* frame_data,
+                                  int child_id,
+                                  PrewalkData* prewalk_data) {
+  ResourceProvider::ResourceIdSet& referenced_resources =
+      prewalk_data->referenced_resources;
   size_t reserve_size = frame_data->resource_list.size();
 #if defined(COMPILER_MSVC)
   referenced_resources.reserve(reserve_size);
@@ -532,14 +674,10 @@ gfx::Rect SurfaceAggregator::PrewalkTree(SurfaceId surface_id) {
     referenced_resources.resize(reserve_size);
 #endif
 
-  bool invalid_frame = false;
   ResourceProvider::ResourceIdMap empty_map;
   const ResourceProvider::ResourceIdMap& child_to_parent_map =
       provider_ ? provider_->GetChildToParentMap(child_id) : empty_map;
 
-  // Each pair in the vector is a child surface and the transform from its
-  // target to the root target of this surface.
-  std::vector<std::pair<SurfaceId, gfx::Transform>> child_surfaces;
   for (const auto& render_pass : frame_data->render_pass_list) {
     for (const auto& quad : render_pass->quad_list) {
       if (quad->material == DrawQuad::SURFACE_CONTENT) {
@@ -548,28 +686,68 @@ gfx::Rect SurfaceAggregator::PrewalkTree(SurfaceId surface_id) {
         gfx::Transform target_to_surface_transform(
             render_pass->transform_to_root_target,
             surface_quad->shared_quad_state->quad_to_target_transform);
-        child_surfaces.push_back(std::make_pair(surface_quad->surface_id,
-                                                target_to_surface_transform));
+        prewalk_data->child_surfaces.push_back(std::make_pair(
+            surface_quad->surface_id, target_to_surface_transform));
       }
 
       if (!provider_)
         continue;
       for (ResourceId resource_id : quad->resources) {
-        if (!child_to_parent_map.count(resource_id)) {
-          invalid_frame = true;
-          break;
-        }
+        if (!child_to_parent_map.count(resource_id))
+          return false;
         referenced_resources.insert(resource_id);
       }
     }
   }
+  return true;
+}
 
-  if (invalid_frame)
+// Walk the Surface tree from surface_id. Validate the resources of the current
+// surface and its descendants, check if there are any copy requests, and
+// return the combined damage rect.
+gfx::Rect SurfaceAggregator::PrewalkTree(SurfaceId surface_id) {
+  if (referenced_surfaces_.count(surface_id))
+    return gfx::Rect();
+  Surface* surface = manager_->GetSurfaceForId(surface_id);
+  if (!surface) {
+    contained_surfaces_[surface_id] = 0;
+    return gfx::Rect();
+  }
+  contained_surfaces_[surface_id] = surface->frame_index();
+  const CompositorFrame* surface_frame = surface->GetEligibleFrame();
+  if (!surface_frame)
+    return gfx::Rect();
+  const DelegatedFrameData* frame_data =
+      surface_frame->delegated_frame_data.get();
+  if (!frame_data)
+    return gfx::Rect();
+  int child_id = 0;
+  // TODO(jbauman): hack for unit tests that don't set up rp
+  if (provider_) {
+    child_id = ChildIdForSurface(surface);
+    if (surface->factory())
+      surface->factory()->RefResources(frame_data->resource_list);
+    provider_->ReceiveFromChild(child_id, frame_data->resource_list);
+  }
+
+  PrewalkData* prewalk_data = prewalk_data_.get(surface_id);
+  if (!prewalk_data || prewalk_data->frame_index != surface->frame_index()) {
+    scoped_ptr<PrewalkData> new_prewalk_data(new PrewalkData);
+    new_prewalk_data->frame_index = surface->frame_index();
+    new_prewalk_data->valid =
+        WalkFrame(frame_data, child_id, new_prewalk_data.get());
+    prewalk_data = new_prewalk_data.get();
+    prewalk_data_.set(surface_id, new_prewalk_data.Pass());
+  }
+
+  if (!prewalk_data->valid)
     return gfx::Rect();
   valid_surfaces_.insert(surface->surface_id());
 
-  if (provider_)
-    provider_->DeclareUsedResourcesFromChild(child_id, referenced_resources);
+  if (provider_) {
+    provider_->DeclareUsedResourcesFromChild(
+        child_id, prewalk_data->referenced_resources);
+  }
 
   for (const auto& render_pass : frame_data->render_pass_list)
     has_copy_requests_ |= !render_pass->copy_requests.empty();
@@ -585,7 +763,7 @@ gfx::Rect SurfaceAggregator::PrewalkTree(SurfaceId surface_id) {
   // referenced_surfaces_.
   SurfaceSet::iterator it =
       referenced_surfaces_.insert(surface->surface_id()).first;
-  for (const auto& surface_info : child_surfaces) {
+  for (const auto& surface_info : prewalk_data->child_surfaces) {
     gfx::Rect surface_damage = PrewalkTree(surface_info.first);
     damage_rect.Union(
         MathUtil::MapEnclosingClippedRect(surface_info.second, surface_damage));
@@ -614,6 +792,10 @@ scoped_ptr<CompositorFrame> SurfaceAggregator::Aggregate(SurfaceId surface_id) {
   valid_surfaces_.clear();
   has_copy_requests_ = false;
   root_damage_rect_ = PrewalkTree(surface_id);
+  // Cached surfaces hold no copy requests.
+  use_cached_surfaces_ = !has_copy_requests_;
+  cached_bytes_ = 0;
+  aggregated_surfaces_.clear();
 
   SurfaceSet::iterator it = referenced_surfaces_.insert(surface_id).first;
   CopyPasses(root_surface_frame->delegated_frame_data.get(), surface);
@@ -629,6 +811,7 @@ scoped_ptr<CompositorFrame> SurfaceAggregator::Aggregate(SurfaceId surface_id) {
   ProcessAddedAndRemovedSurfaces();
   contained_surfaces_.swap(previous_contained_surfaces_);
   contained_surfaces_.clear();
+  RemoveUncontainedSurfacesFromCaches();
 
   for (SurfaceIndexMap::iterator it = previous_contained_surfaces_.begin();
        it != previous_contained_surfaces_.end();
@@ -653,6 +836,24 @@ void SurfaceAggregator::ReleaseResources(SurfaceId surface_id) {
   }
 }
 
+void SurfaceAggregator::RemoveUncontainedSurfacesFromCaches() {
+  std::vector<SurfaceId> uncontained_surfaces;
+  for (const auto& cached_surface : cached_surfaces_) {
+    if (!previous_contained_surfaces_.count(cached_surface.first))
+      uncontained_surfaces.push_back(cached_surface.first);
+  }
+  for (SurfaceId surface_id : uncontained_surfaces)
+    cached_surfaces_.erase(surface_id);
+
+  uncontained_surfaces.clear();
+  for (const auto& prewalk_data : prewalk_data_) {
+    if (!previous_contained_surfaces_.count(prewalk_data.first))
+      uncontained_surfaces.push_back(prewalk_data.first);
+  }
+  for (SurfaceId surface_id : uncontained_surfaces)
+    prewalk_data_.erase(surface_id);
+}
+
 void SurfaceAggregator::SetFullDamageForSurface(SurfaceId surface_id) {
   auto it = previous_contained_surfaces_.find(surface_id);
   if (it == previous_contained_surfaces_.end())
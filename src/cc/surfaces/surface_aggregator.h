@@ -6,6 +6,8 @@
 #define CC_SURFACES_SURFACE_AGGREGATOR_H_
 
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "base/containers/hash_tables.h"
 #include "base/containers/scoped_ptr_hash_map.h"
@@ -31,6 +33,9 @@ class CC_SURFACES_EXPORT SurfaceAggregatorClient {
 
   virtual void AddSurface(Surface* surface) = 0;
   virtual void RemoveSurface(Surface* surface) = 0;
+  // Returns true if the renderer kept the contents it drew for the pass |id|
+  // with RenderPass::cache_contents.
+  virtual bool HasCachedRenderPass(RenderPassId id) const = 0;
 };
 
 class CC_SURFACES_EXPORT SurfaceAggregator {
@@ -60,6 +65,11 @@ class CC_SURFACES_EXPORT SurfaceAggregator {
     gfx::Rect rect;
   };
 
+  // What a surface whose pass the renderer caches was drawn from.
+  struct CachedSurface;
+  // What PrewalkTree() finds in a surface's frame.
+  struct PrewalkData;
+
   ClipData CalculateClipRect(const ClipData& surface_clip,
                              const ClipData& quad_clip,
                              const gfx::Transform& target_transform);
@@ -67,6 +77,26 @@ class CC_SURFACES_EXPORT SurfaceAggregator {
   RenderPassId RemapPassId(RenderPassId surface_local_pass_id,
                            SurfaceId surface_id);
 
+  // Draws |surface_quad|'s surface with the contents the renderer cached for
+  // its pass, if the surface and its descendants kept their frames since.
+  // |source| is the last pass of the surface's frame. Returns false if there
+  // are no such contents, or if they don't fit in the cache for this frame.
+  bool AppendCachedSurface(const SurfaceDrawQuad* surface_quad,
+                           const RenderPass& source,
+                           const gfx::Transform& target_transform,
+                           const ClipData& clip_rect,
+                           RenderPass* dest_pass);
+  // Draws the pass |render_pass_id| of |surface_quad|'s surface into
+  // |dest_pass|, where the surface quad is.
+  void AppendSurfacePassQuad(const SurfaceDrawQuad* surface_quad,
+                             const gfx::Transform& target_transform,
+                             const ClipData& clip_rect,
+                             RenderPassId render_pass_id,
+                             RenderPass* dest_pass);
+  // Returns true if the output of the surfaces in |aggregated_surfaces_| from
+  // |first_surface| on can be cached.
+  bool CanCacheSurfaces(size_t first_surface) const;
+
   void HandleSurfaceQuad(const SurfaceDrawQuad* surface_quad,
                          const gfx::Transform& target_transform,
                          const ClipData& clip_rect,
@@ -84,6 +114,11 @@ class CC_SURFACES_EXPORT SurfaceAggregator {
       RenderPass* dest_pass,
       SurfaceId surface_id);
   gfx::Rect PrewalkTree(SurfaceId surface_id);
+  // Finds the child surfaces and resources of |frame_data|. Returns false if
+  // the frame uses resources it didn't send.
+  bool WalkFrame(const DelegatedFrameData* frame_data,
+                 int child_id,
+                 PrewalkData* prewalk_data);
   void CopyPasses(const DelegatedFrameData* frame_data, Surface* surface);
 
   // Remove Surfaces that were referenced before but aren't currently
@@ -91,6 +126,8 @@ class CC_SURFACES_EXPORT SurfaceAggregator {
   // Also notifies SurfaceAggregatorClient of newly added and removed
   // child surfaces.
   void ProcessAddedAndRemovedSurfaces();
+  // Drops cache entries of surfaces that weren't in the last aggregation.
+  void RemoveUncontainedSurfacesFromCaches();
 
   int ChildIdForSurface(Surface* surface);
   gfx::Rect DamageRectForSurface(const Surface* surface,
@@ -101,6 +138,20 @@ class CC_SURFACES_EXPORT SurfaceAggregator {
   SurfaceManager* manager_;
   ResourceProvider* provider_;
 
+  typedef base::ScopedPtrHashMap<SurfaceId, scoped_ptr<CachedSurface>>
+      CachedSurfaceMap;
+  // The surfaces drawn into passes with RenderPass::cache_contents, because
+  // they had no new frame since the aggregation before. Later aggregations of
+  // frames without copy requests reuse those passes while the renderer keeps
+  // them.
+  CachedSurfaceMap cached_surfaces_;
+
+  // What PrewalkTree() found in the surfaces' frames, kept until they get a
+  // new frame.
+  typedef base::ScopedPtrHashMap<SurfaceId, scoped_ptr<PrewalkData>>
+      PrewalkDataMap;
+  PrewalkDataMap prewalk_data_;
+
   class RenderPassIdAllocator;
   typedef base::ScopedPtrHashMap<SurfaceId, scoped_ptr<RenderPassIdAllocator>>
       RenderPassIdAllocatorMap;
@@ -138,6 +189,21 @@ class CC_SURFACES_EXPORT SurfaceAggregator {
   // This is valid during Aggregate after PrewalkTree is called.
   bool has_copy_requests_;
 
+  // True if |cached_surfaces_| can be used for the current aggregation.
+  bool use_cached_surfaces_;
+
+  // True while aggregating into the passes of a cached surface. They are
+  // aggregated in full, whatever the damage.
+  bool caching_surface_;
+
+  // The size of the passes of cached surfaces in the current aggregation,
+  // bounded by kMaxCachedSurfaceBytes.
+  size_t cached_bytes_;
+
+  // The surfaces handled so far in the current aggregation, in order, with
+  // their frame index at the time.
+  std::vector<std::pair<SurfaceId, int>> aggregated_surfaces_;
+
   // Resource list for the aggregated frame.
   TransferableResourceArray* dest_resource_list_;
 
@@ -4,6 +4,14 @@
 
 #include "cc/tiles/image_decode_controller.h"
 
+#include <string>
+#include <utility>
+
+#include "base/strings/stringprintf.h"
+#include "base/thread_task_runner_handle.h"
+#include "base/trace_event/memory_allocator_dump.h"
+#include "base/trace_event/memory_dump_manager.h"
+#include "base/trace_event/process_memory_dump.h"
 #include "cc/debug/devtools_instrumentation.h"
 
 namespace cc {
@@ -17,6 +25,7 @@ class ImageDecodeTaskImpl : public ImageDecodeTask {
                       uint64_t source_prepare_tiles_id)
       : controller_(controller),
         image_(skia::SharePtr(image)),
+        image_id_(image->uniqueID()),
         layer_id_(layer_id),
         source_prepare_tiles_id_(source_prepare_tiles_id) {}
 
@@ -36,7 +45,7 @@ class ImageDecodeTaskImpl : public ImageDecodeTask {
   // Overridden from TileTask:
   void ScheduleOnOriginThread(TileTaskClient* client) override {}
   void CompleteOnOriginThread(TileTaskClient* client) override {
-    controller_->OnImageDecodeTaskCompleted(layer_id_, image_.get(),
+    controller_->OnImageDecodeTaskCompleted(this, layer_id_, image_id_,
                                             !HasFinishedRunning());
   }
 
@@ -46,6 +55,7 @@ class ImageDecodeTaskImpl : public ImageDecodeTask {
  private:
   ImageDecodeController* controller_;
   skia::RefPtr<const SkImage> image_;
+  uint32_t image_id_;
   int layer_id_;
   uint64_t source_prepare_tiles_id_;
 
@@ -54,20 +64,46 @@ class ImageDecodeTaskImpl : public ImageDecodeTask {
 
 }  // namespace
 
-ImageDecodeController::ImageDecodeController() {}
+ImageDecodeController::DecodedImage::DecodedImage() {}
 
-ImageDecodeController::~ImageDecodeController() {}
+ImageDecodeController::DecodedImage::~DecodedImage() {}
+
+ImageDecodeController::ImageDecodeController()
+    : cache_hits_(0), cache_misses_(0), decode_count_(0) {
+  // Everything but the decode statistics is only accessed on this thread.
+  if (base::ThreadTaskRunnerHandle::IsSet()) {
+    base::trace_event::MemoryDumpManager::GetInstance()->RegisterDumpProvider(
+        this, "cc::ImageDecodeController",
+        base::ThreadTaskRunnerHandle::Get());
+  }
+}
+
+ImageDecodeController::~ImageDecodeController() {
+  base::trace_event::MemoryDumpManager::GetInstance()->UnregisterDumpProvider(
+      this);
+}
 
 scoped_refptr<ImageDecodeTask> ImageDecodeController::GetTaskForImage(
     const DrawImage& image,
     int layer_id,
     uint64_t prepare_tiles_id) {
-  uint32_t generation_id = image.image()->uniqueID();
-  scoped_refptr<ImageDecodeTask>& decode_task =
-      image_decode_tasks_[layer_id][generation_id];
-  if (!decode_task)
-    decode_task = CreateTaskForImage(image.image(), layer_id, prepare_tiles_id);
-  return decode_task;
+  uint32_t image_id = image.image()->uniqueID();
+  DecodedImageMap::iterator it = decoded_images_.find(image_id);
+  if (it == decoded_images_.end()) {
+    // The image is decoded at its own size, whatever the scale it is drawn
+    // at, so that a single decode serves every layer and scale.
+    ++cache_misses_;
+    it = decoded_images_.insert(std::make_pair(image_id, DecodedImage())).first;
+    it->second.task =
+        CreateTaskForImage(image.image(), layer_id, prepare_tiles_id);
+  } else {
+    ++cache_hits_;
+  }
+
+  DecodedImage& decoded_image = it->second;
+  if (decoded_image.layer_ids.insert(layer_id).second)
+    layer_images_[layer_id].insert(image_id);
+  return decoded_image.task;
 }
 
 scoped_refptr<ImageDecodeTask> ImageDecodeController::CreateTaskForImage(
@@ -79,7 +115,13 @@ scoped_refptr<ImageDecodeTask> ImageDecodeController::CreateTaskForImage(
 }
 
 void ImageDecodeController::DecodeImage(const SkImage* image) {
+  base::TimeTicks start_time = base::TimeTicks::Now();
   image->preroll();
+  base::TimeDelta duration = base::TimeTicks::Now() - start_time;
+
+  base::AutoLock lock(decode_stats_lock_);
+  ++decode_count_;
+  total_decode_duration_ += duration;
 }
 
 void ImageDecodeController::AddLayerUsedCount(int layer_id) {
@@ -90,31 +132,78 @@ void ImageDecodeController::SubtractLayerUsedCount(int layer_id) {
   if (--used_layer_counts_[layer_id])
     return;
 
-  // Clean up decode tasks once a layer is no longer used.
+  // Clean up decodes once a layer is no longer used, unless another layer
+  // still draws the image.
   used_layer_counts_.erase(layer_id);
-  image_decode_tasks_.erase(layer_id);
+  LayerImageMap::iterator layer_it = layer_images_.find(layer_id);
+  if (layer_it == layer_images_.end())
+    return;
+
+  ImageIdSet image_ids;
+  image_ids.swap(layer_it->second);
+  layer_images_.erase(layer_it);
+  for (uint32_t image_id : image_ids) {
+    DecodedImageMap::iterator it = decoded_images_.find(image_id);
+    DCHECK(it != decoded_images_.end());
+    it->second.layer_ids.erase(layer_id);
+    if (it->second.layer_ids.empty())
+      EraseDecodedImage(image_id);
+  }
 }
 
-void ImageDecodeController::OnImageDecodeTaskCompleted(int layer_id,
-                                                       const SkImage* image,
+void ImageDecodeController::OnImageDecodeTaskCompleted(ImageDecodeTask* task,
+                                                       int layer_id,
+                                                       uint32_t image_id,
                                                        bool was_canceled) {
-  // If the task has successfully finished, then keep the task until the layer
-  // is no longer in use. This ensures that we only decode a image once.
+  // If the task has successfully finished, then keep the task until no layer
+  // uses the image. This ensures that we only decode an image once.
   // TODO(vmpstr): Remove this when decode lifetime is controlled by cc.
   if (!was_canceled)
     return;
 
   // Otherwise, we have to clean up the task so that a new one can be created if
-  // we need to decode the image again.
-  LayerImageTaskMap::iterator layer_it = image_decode_tasks_.find(layer_id);
-  if (layer_it == image_decode_tasks_.end())
-    return;
+  // we need to decode the image again. The entry may already have been erased
+  // and replaced by a newer task for the same image, which must be kept.
+  DecodedImageMap::iterator it = decoded_images_.find(image_id);
+  if (it != decoded_images_.end() && it->second.task.get() == task)
+    EraseDecodedImage(image_id);
+}
 
-  ImageTaskMap& image_tasks = layer_it->second;
-  ImageTaskMap::iterator task_it = image_tasks.find(image->uniqueID());
-  if (task_it == image_tasks.end())
-    return;
-  image_tasks.erase(task_it);
+bool ImageDecodeController::OnMemoryDump(
+    const base::trace_event::MemoryDumpArgs& args,
+    base::trace_event::ProcessMemoryDump* pmd) {
+  std::string name = base::StringPrintf("cc/image_decode_controller/%p", this);
+  base::trace_event::MemoryAllocatorDump* dump = pmd->CreateAllocatorDump(name);
+  // The decoded pixels are owned and accounted for by Skia's discardable
+  // memory, so the controller only reports what it scheduled.
+  dump->AddScalar(base::trace_event::MemoryAllocatorDump::kNameObjectCount,
+                  base::trace_event::MemoryAllocatorDump::kUnitsObjects,
+                  decoded_images_.size());
+  dump->AddScalar("cache_hits",
+                  base::trace_event::MemoryAllocatorDump::kUnitsObjects,
+                  cache_hits_);
+  dump->AddScalar("cache_misses",
+                  base::trace_event::MemoryAllocatorDump::kUnitsObjects,
+                  cache_misses_);
+
+  base::AutoLock lock(decode_stats_lock_);
+  dump->AddScalar("decode_count",
+                  base::trace_event::MemoryAllocatorDump::kUnitsObjects,
+                  decode_count_);
+  dump->AddScalar("total_decode_time_us", "microseconds",
+                  total_decode_duration_.InMicroseconds());
+  return true;
+}
+
+void ImageDecodeController::EraseDecodedImage(uint32_t image_id) {
+  DecodedImageMap::iterator it = decoded_images_.find(image_id);
+  DCHECK(it != decoded_images_.end());
+  for (int layer_id : it->second.layer_ids) {
+    LayerImageMap::iterator layer_it = layer_images_.find(layer_id);
+    if (layer_it != layer_images_.end())
+      layer_it->second.erase(image_id);
+  }
+  decoded_images_.erase(it);
 }
 
 }  // namespace cc
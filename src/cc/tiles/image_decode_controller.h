@@ -7,6 +7,9 @@
 
 #include "base/containers/hash_tables.h"
 #include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "base/trace_event/memory_dump_provider.h"
 #include "cc/base/cc_export.h"
 #include "cc/playback/discardable_image_map.h"
 #include "cc/raster/tile_task_runner.h"
@@ -14,10 +17,16 @@
 
 namespace cc {
 
-class ImageDecodeController {
+// Schedules image decodes ahead of the raster tasks that need them. An image
+// is decoded once at its intrinsic size, whatever the number of layers and
+// scales it is drawn at. The decoded pixels are kept and evicted by Skia's
+// discardable memory; the controller only tracks which decodes were
+// scheduled, and reports cache and decode statistics to memory-infra.
+class CC_EXPORT ImageDecodeController
+    : public base::trace_event::MemoryDumpProvider {
  public:
   ImageDecodeController();
-  ~ImageDecodeController();
+  ~ImageDecodeController() override;
 
   scoped_refptr<ImageDecodeTask> GetTaskForImage(const DrawImage& image,
                                                  int layer_id,
@@ -31,21 +40,51 @@ class ImageDecodeController {
   void AddLayerUsedCount(int layer_id);
   void SubtractLayerUsedCount(int layer_id);
 
-  void OnImageDecodeTaskCompleted(int layer_id,
-                                  const SkImage* image,
+  void OnImageDecodeTaskCompleted(ImageDecodeTask* task,
+                                  int layer_id,
+                                  uint32_t image_id,
                                   bool was_canceled);
 
+  // Overridden from base::trace_event::MemoryDumpProvider:
+  bool OnMemoryDump(const base::trace_event::MemoryDumpArgs& args,
+                    base::trace_event::ProcessMemoryDump* pmd) override;
+
  private:
+  struct DecodedImage {
+    DecodedImage();
+    ~DecodedImage();
+
+    scoped_refptr<ImageDecodeTask> task;
+    // The layers that draw the image.
+    base::hash_set<int> layer_ids;
+  };
+
   scoped_refptr<ImageDecodeTask> CreateTaskForImage(const SkImage* image,
                                                     int layer_id,
                                                     uint64_t prepare_tiles_id);
 
-  using ImageTaskMap = base::hash_map<uint32_t, scoped_refptr<ImageDecodeTask>>;
-  using LayerImageTaskMap = base::hash_map<int, ImageTaskMap>;
-  LayerImageTaskMap image_decode_tasks_;
+  void EraseDecodedImage(uint32_t image_id);
+
+  using DecodedImageMap = base::hash_map<uint32_t, DecodedImage>;
+  DecodedImageMap decoded_images_;
+
+  // The images drawn by each layer.
+  using ImageIdSet = base::hash_set<uint32_t>;
+  using LayerImageMap = base::hash_map<int, ImageIdSet>;
+  LayerImageMap layer_images_;
 
   using LayerCountMap = base::hash_map<int, int>;
   LayerCountMap used_layer_counts_;
+
+  uint64_t cache_hits_;
+  uint64_t cache_misses_;
+
+  // Decode statistics, updated by worker threads.
+  base::Lock decode_stats_lock_;
+  uint64_t decode_count_;
+  base::TimeDelta total_decode_duration_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImageDecodeController);
 };
 
 }  // namespace cc
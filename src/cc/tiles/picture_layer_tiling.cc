@@ -32,6 +32,37 @@ namespace {
 const float kSoonBorderDistanceViewportPercentage = 0.15f;
 const float kMaxSoonBorderDistanceInScreenPixels = 312.f;
 
+// The edges of a rect, in the order left, top, right, bottom.
+const int kNumEdges = 4;
+void GetEdges(const gfx::Rect& rect, double edges[kNumEdges]) {
+  edges[0] = rect.x();
+  edges[1] = rect.y();
+  edges[2] = rect.right();
+  edges[3] = rect.bottom();
+}
+
+// Returns how far an edge moving at |velocity| and |acceleration| travels in
+// |time|. An edge that decelerates, as during a fling, stops where it would
+// come to rest instead of turning back. Acceleration is estimated from few
+// integer samples and is noisy, so it can at most double the distance of the
+// linear extrapolation, and an edge at rest isn't moved.
+double ExtrapolateEdgeDistance(double velocity,
+                               double acceleration,
+                               double time) {
+  if (velocity == 0.0)
+    return 0.0;
+  double linear_distance = velocity * time;
+  if (velocity * acceleration < 0.0) {
+    double stop_time = -velocity / acceleration;
+    if (stop_time < time)
+      return 0.5 * velocity * stop_time;
+  }
+  double distance = linear_distance + 0.5 * acceleration * time * time;
+  if (std::abs(distance) > 2.0 * std::abs(linear_distance))
+    return 2.0 * linear_distance;
+  return distance;
+}
+
 }  // namespace
 
 scoped_ptr<PictureLayerTiling> PictureLayerTiling::Create(
@@ -41,11 +72,13 @@ scoped_ptr<PictureLayerTiling> PictureLayerTiling::Create(
     PictureLayerTilingClient* client,
     size_t tiling_interest_area_padding,
     float skewport_target_time_in_seconds,
-    int skewport_extrapolation_limit_in_content_pixels) {
+    int skewport_extrapolation_limit_in_content_pixels,
+    bool use_skewport_acceleration) {
   return make_scoped_ptr(new PictureLayerTiling(
       tree, contents_scale, raster_source, client, tiling_interest_area_padding,
       skewport_target_time_in_seconds,
-      skewport_extrapolation_limit_in_content_pixels));
+      skewport_extrapolation_limit_in_content_pixels,
+      use_skewport_acceleration));
 }
 
 PictureLayerTiling::PictureLayerTiling(
@@ -55,11 +88,13 @@ PictureLayerTiling::PictureLayerTiling(
     PictureLayerTilingClient* client,
     size_t tiling_interest_area_padding,
     float skewport_target_time_in_seconds,
-    int skewport_extrapolation_limit_in_content_pixels)
+    int skewport_extrapolation_limit_in_content_pixels,
+    bool use_skewport_acceleration)
     : tiling_interest_area_padding_(tiling_interest_area_padding),
       skewport_target_time_in_seconds_(skewport_target_time_in_seconds),
       skewport_extrapolation_limit_in_content_pixels_(
           skewport_extrapolation_limit_in_content_pixels),
+      use_skewport_acceleration_(use_skewport_acceleration),
       contents_scale_(contents_scale),
       client_(client),
       tree_(tree),
@@ -577,20 +612,49 @@ gfx::Rect PictureLayerTiling::ComputeSkewport(
   if (time_delta == 0.0)
     return skewport;
 
-  double extrapolation_multiplier =
-      skewport_target_time_in_seconds_ / time_delta;
-
-  int old_x = visible_rect_history_[1].visible_rect_in_content_space.x();
-  int old_y = visible_rect_history_[1].visible_rect_in_content_space.y();
-  int old_right =
-      visible_rect_history_[1].visible_rect_in_content_space.right();
-  int old_bottom =
-      visible_rect_history_[1].visible_rect_in_content_space.bottom();
+  const FrameVisibleRect& old_frame = visible_rect_history_[1];
+  double old_edges[kNumEdges];
+  double new_edges[kNumEdges];
+  GetEdges(old_frame.visible_rect_in_content_space, old_edges);
+  GetEdges(visible_rect_in_content_space, new_edges);
+
+  double velocities[kNumEdges];
+  for (int i = 0; i < kNumEdges; ++i)
+    velocities[i] = (new_edges[i] - old_edges[i]) / time_delta;
+
+  // The acceleration compares the velocity above with the one measured a
+  // frame earlier, over the two frames before the last one.
+  double accelerations[kNumEdges] = {0.0, 0.0, 0.0, 0.0};
+  const FrameVisibleRect& last_frame = visible_rect_history_[0];
+  const FrameVisibleRect& oldest_frame = visible_rect_history_[2];
+  double last_time_delta =
+      last_frame.frame_time_in_seconds - oldest_frame.frame_time_in_seconds;
+  if (use_skewport_acceleration_ && last_time_delta > 0.0) {
+    double last_edges[kNumEdges];
+    double oldest_edges[kNumEdges];
+    GetEdges(last_frame.visible_rect_in_content_space, last_edges);
+    GetEdges(oldest_frame.visible_rect_in_content_space, oldest_edges);
+    // Time between the midpoints of the two measurements.
+    double velocity_time_delta =
+        (current_frame_time_in_seconds + old_frame.frame_time_in_seconds -
+         last_frame.frame_time_in_seconds -
+         oldest_frame.frame_time_in_seconds) /
+        2.0;
+    if (velocity_time_delta > 0.0) {
+      for (int i = 0; i < kNumEdges; ++i) {
+        double last_velocity =
+            (last_edges[i] - oldest_edges[i]) / last_time_delta;
+        accelerations[i] =
+            (velocities[i] - last_velocity) / velocity_time_delta;
+      }
+    }
+  }
 
-  int new_x = visible_rect_in_content_space.x();
-  int new_y = visible_rect_in_content_space.y();
-  int new_right = visible_rect_in_content_space.right();
-  int new_bottom = visible_rect_in_content_space.bottom();
+  double distances[kNumEdges];
+  for (int i = 0; i < kNumEdges; ++i) {
+    distances[i] = ExtrapolateEdgeDistance(
+        velocities[i], accelerations[i], skewport_target_time_in_seconds_);
+  }
 
   // Compute the maximum skewport based on
   // |skewport_extrapolation_limit_in_content_pixels_|.
@@ -599,10 +663,7 @@ gfx::Rect PictureLayerTiling::ComputeSkewport(
                      -skewport_extrapolation_limit_in_content_pixels_);
 
   // Inset the skewport by the needed adjustment.
-  skewport.Inset(extrapolation_multiplier * (new_x - old_x),
-                 extrapolation_multiplier * (new_y - old_y),
-                 extrapolation_multiplier * (old_right - new_right),
-                 extrapolation_multiplier * (old_bottom - new_bottom));
+  skewport.Inset(distances[0], distances[1], -distances[2], -distances[3]);
 
   // Ensure that visible rect is contained in the skewport.
   skewport.Union(visible_rect_in_content_space);
@@ -99,7 +99,8 @@ class CC_EXPORT PictureLayerTiling {
       PictureLayerTilingClient* client,
       size_t tiling_interest_area_padding,
       float skewport_target_time_in_seconds,
-      int skewport_extrapolation_limit_in_content_pixels);
+      int skewport_extrapolation_limit_in_content_pixels,
+      bool use_skewport_acceleration);
 
   void SetRasterSourceAndResize(
       scoped_refptr<DisplayListRasterSource> raster_source);
@@ -284,7 +285,8 @@ class CC_EXPORT PictureLayerTiling {
                      PictureLayerTilingClient* client,
                      size_t tiling_interest_area_padding,
                      float skewport_target_time_in_seconds,
-                     int skewport_extrapolation_limit_in_content_pixels);
+                     int skewport_extrapolation_limit_in_content_pixels,
+                     bool use_skewport_acceleration);
   void SetLiveTilesRect(const gfx::Rect& live_tiles_rect);
   void VerifyLiveTilesRect(bool is_on_recycle_tree) const;
   Tile* CreateTile(const Tile::CreateInfo& info);
@@ -295,8 +297,11 @@ class CC_EXPORT PictureLayerTiling {
 
   // Computes a skewport. The calculation extrapolates the last visible
   // rect and the current visible rect to expand the skewport to where it
-  // would be in |skewport_target_time| seconds. Note that the skewport
-  // is guaranteed to contain the current visible rect.
+  // would be in |skewport_target_time| seconds. With
+  // |use_skewport_acceleration_|, the change in velocity over the frames
+  // before is taken into account too, so that a decelerating fling expands
+  // the skewport only up to where it stops. Note that the skewport is
+  // guaranteed to contain the current visible rect.
   gfx::Rect ComputeSkewport(double current_frame_time_in_seconds,
                             const gfx::Rect& visible_rect_in_content_space)
       const;
@@ -319,13 +324,16 @@ class CC_EXPORT PictureLayerTiling {
   void UpdateVisibleRectHistory(
       double frame_time_in_seconds,
       const gfx::Rect& visible_rect_in_content_space) {
+    visible_rect_history_[2] = visible_rect_history_[1];
     visible_rect_history_[1] = visible_rect_history_[0];
     visible_rect_history_[0].frame_time_in_seconds = frame_time_in_seconds;
     visible_rect_history_[0].visible_rect_in_content_space =
         visible_rect_in_content_space;
-    // If we don't have a second history item, set it to the most recent one.
+    // If we don't have older history items, set them to the most recent one.
     if (visible_rect_history_[1].frame_time_in_seconds == 0.0)
       visible_rect_history_[1] = visible_rect_history_[0];
+    if (visible_rect_history_[2].frame_time_in_seconds == 0.0)
+      visible_rect_history_[2] = visible_rect_history_[1];
   }
   bool IsTileOccludedOnCurrentTree(const Tile* tile) const;
   Tile::CreateInfo CreateInfoForTile(int i, int j) const;
@@ -374,6 +382,7 @@ class CC_EXPORT PictureLayerTiling {
   const size_t tiling_interest_area_padding_;
   const float skewport_target_time_in_seconds_;
   const int skewport_extrapolation_limit_in_content_pixels_;
+  const bool use_skewport_acceleration_;
 
   // Given properties.
   const float contents_scale_;
@@ -390,7 +399,7 @@ class CC_EXPORT PictureLayerTiling {
 
   gfx::Rect last_viewport_in_layer_space_;
   // State saved for computing velocities based upon finite differences.
-  FrameVisibleRect visible_rect_history_[2];
+  FrameVisibleRect visible_rect_history_[3];
 
   bool can_require_tiles_for_activation_;
 
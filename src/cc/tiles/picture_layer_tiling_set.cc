@@ -35,11 +35,13 @@ scoped_ptr<PictureLayerTilingSet> PictureLayerTilingSet::Create(
     PictureLayerTilingClient* client,
     size_t tiling_interest_area_padding,
     float skewport_target_time_in_seconds,
-    int skewport_extrapolation_limit_in_content_pixels) {
+    int skewport_extrapolation_limit_in_content_pixels,
+    bool use_skewport_acceleration) {
   return make_scoped_ptr(new PictureLayerTilingSet(
       tree, client, tiling_interest_area_padding,
       skewport_target_time_in_seconds,
-      skewport_extrapolation_limit_in_content_pixels));
+      skewport_extrapolation_limit_in_content_pixels,
+      use_skewport_acceleration));
 }
 
 PictureLayerTilingSet::PictureLayerTilingSet(
@@ -47,11 +49,13 @@ PictureLayerTilingSet::PictureLayerTilingSet(
     PictureLayerTilingClient* client,
     size_t tiling_interest_area_padding,
     float skewport_target_time_in_seconds,
-    int skewport_extrapolation_limit_in_content_pixels)
+    int skewport_extrapolation_limit_in_content_pixels,
+    bool use_skewport_acceleration)
     : tiling_interest_area_padding_(tiling_interest_area_padding),
       skewport_target_time_in_seconds_(skewport_target_time_in_seconds),
       skewport_extrapolation_limit_in_content_pixels_(
           skewport_extrapolation_limit_in_content_pixels),
+      use_skewport_acceleration_(use_skewport_acceleration),
       tree_(tree),
       client_(client) {}
 
@@ -78,7 +82,8 @@ void PictureLayerTilingSet::CopyTilingsAndPropertiesFromPendingTwin(
       scoped_ptr<PictureLayerTiling> new_tiling = PictureLayerTiling::Create(
           tree_, contents_scale, raster_source, client_,
           tiling_interest_area_padding_, skewport_target_time_in_seconds_,
-          skewport_extrapolation_limit_in_content_pixels_);
+          skewport_extrapolation_limit_in_content_pixels_,
+          use_skewport_acceleration_);
       tilings_.push_back(new_tiling.Pass());
       this_tiling = tilings_.back();
       tiling_sort_required = true;
@@ -251,7 +256,8 @@ PictureLayerTiling* PictureLayerTilingSet::AddTiling(
   tilings_.push_back(PictureLayerTiling::Create(
       tree_, contents_scale, raster_source, client_,
       tiling_interest_area_padding_, skewport_target_time_in_seconds_,
-      skewport_extrapolation_limit_in_content_pixels_));
+      skewport_extrapolation_limit_in_content_pixels_,
+      use_skewport_acceleration_));
   PictureLayerTiling* appended = tilings_.back();
 
   tilings_.sort(LargestToSmallestScaleFunctor());
@@ -42,7 +42,8 @@ class CC_EXPORT PictureLayerTilingSet {
       PictureLayerTilingClient* client,
       size_t tiling_interest_area_padding,
       float skewport_target_time_in_seconds,
-      int skewport_extrapolation_limit_in_content);
+      int skewport_extrapolation_limit_in_content,
+      bool use_skewport_acceleration);
 
   ~PictureLayerTilingSet();
 
@@ -177,7 +178,8 @@ class CC_EXPORT PictureLayerTilingSet {
       PictureLayerTilingClient* client,
       size_t tiling_interest_area_padding,
       float skewport_target_time_in_seconds,
-      int skewport_extrapolation_limit_in_content_pixels);
+      int skewport_extrapolation_limit_in_content_pixels,
+      bool use_skewport_acceleration);
 
   void CopyTilingsAndPropertiesFromPendingTwin(
       const PictureLayerTilingSet* pending_twin_set,
@@ -193,6 +195,7 @@ class CC_EXPORT PictureLayerTilingSet {
   const size_t tiling_interest_area_padding_;
   const float skewport_target_time_in_seconds_;
   const int skewport_extrapolation_limit_in_content_pixels_;
+  const bool use_skewport_acceleration_;
   WhichTree tree_;
   PictureLayerTilingClient* client_;
 
@@ -588,8 +588,7 @@ void ComputeClips(ClipTree* clip_tree,
 void ComputeTransforms(TransformTree* transform_tree) {
   if (!transform_tree->needs_update())
     return;
-  for (int i = 1; i < static_cast<int>(transform_tree->size()); ++i)
-    transform_tree->UpdateTransforms(i);
+  transform_tree->UpdateChangedTransforms();
   transform_tree->set_needs_update(false);
 }
 
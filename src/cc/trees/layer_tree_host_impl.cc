@@ -864,6 +864,9 @@ DrawResult LayerTreeHostImpl::CalculateRenderPasses(
   int num_incomplete_tiles = 0;
   int64 checkerboarded_no_recording_content_area = 0;
   int64 checkerboarded_needs_raster_content_area = 0;
+  // Frames drawn during a scroll or fling are reported separately, so that
+  // checkerboarding caused by scrolling can be measured.
+  const bool is_scrolling = !!CurrentlyScrollingLayer();
   bool have_copy_request = false;
   bool have_missing_animated_tiles = false;
 
@@ -943,6 +946,12 @@ DrawResult LayerTreeHostImpl::CalculateRenderPasses(
         append_quads_data.checkerboarded_no_recording_content_area);
     rendering_stats_instrumentation_->AddCheckerboardedNeedsRasterContentArea(
         append_quads_data.checkerboarded_needs_raster_content_area);
+    if (is_scrolling) {
+      rendering_stats_instrumentation_->AddScrollingVisibleContentArea(
+          append_quads_data.visible_layer_area);
+      rendering_stats_instrumentation_->AddCheckerboardedScrollingContentArea(
+          append_quads_data.checkerboarded_visible_content_area);
+    }
 
     num_missing_tiles += append_quads_data.num_missing_tiles;
     num_incomplete_tiles += append_quads_data.num_incomplete_tiles;
@@ -2102,9 +2111,14 @@ void LayerTreeHostImpl::CreateAndSetRenderer() {
         resource_provider_.get(), texture_mailbox_deleter_.get(),
         settings_.renderer_settings.highp_threshold_min);
   } else if (output_surface_->software_device()) {
-    renderer_ =
+    scoped_ptr<SoftwareRenderer> software_renderer =
         SoftwareRenderer::Create(this, &settings_.renderer_settings,
                                  output_surface_, resource_provider_.get());
+    // Without an impl thread the workers would only be run when idle, so
+    // bands are drawn in parallel only with a real raster worker pool.
+    if (!is_synchronous_single_threaded_ && task_graph_runner_)
+      software_renderer->SetTaskGraphRunner(task_graph_runner_);
+    renderer_ = software_renderer.Pass();
   }
   DCHECK(renderer_);
 
@@ -2528,6 +2542,8 @@ InputHandler::ScrollStatus LayerTreeHostImpl::ScrollBegin(
 InputHandler::ScrollStatus LayerTreeHostImpl::ScrollAnimated(
     const gfx::Point& viewport_point,
     const gfx::Vector2dF& scroll_delta) {
+  rendering_stats_instrumentation_->DidHandleInputEvent(
+      base::TimeTicks::Now());
   if (LayerImpl* layer_impl = CurrentlyScrollingLayer()) {
     return ScrollAnimationUpdateTarget(layer_impl, scroll_delta)
                ? SCROLL_STARTED
@@ -2736,6 +2752,8 @@ InputHandlerScrollResult LayerTreeHostImpl::ScrollBy(
     const gfx::Point& viewport_point,
     const gfx::Vector2dF& scroll_delta) {
   TRACE_EVENT0("cc", "LayerTreeHostImpl::ScrollBy");
+  rendering_stats_instrumentation_->DidHandleInputEvent(
+      base::TimeTicks::Now());
   if (!CurrentlyScrollingLayer())
     return InputHandlerScrollResult();
 
@@ -2972,6 +2990,8 @@ void LayerTreeHostImpl::PinchGestureBegin() {
 void LayerTreeHostImpl::PinchGestureUpdate(float magnify_delta,
                                            const gfx::Point& anchor) {
   TRACE_EVENT0("cc", "LayerTreeHostImpl::PinchGestureUpdate");
+  rendering_stats_instrumentation_->DidHandleInputEvent(
+      base::TimeTicks::Now());
   if (!InnerViewportScrollLayer())
     return;
   viewport()->PinchUpdate(magnify_delta, anchor);
@@ -53,6 +53,7 @@ LayerTreeSettings::LayerTreeSettings()
       tiling_interest_area_padding(3000),
       skewport_target_time_in_seconds(1.0f),
       skewport_extrapolation_limit_in_content_pixels(2000),
+      use_skewport_acceleration(false),
       max_memory_for_prepaint_percentage(100),
       strict_layer_property_change_checking(false),
       use_zero_copy(false),
@@ -25,6 +25,7 @@ PropertyTree<T>::~PropertyTree() {
 
 TransformTree::TransformTree()
     : source_to_parent_updates_allowed_(true),
+      needs_full_update_(true),
       page_scale_factor_(1.f),
       device_scale_factor_(1.f),
       device_transform_scale_factor_(1.f) {}
@@ -59,6 +60,7 @@ TransformNodeData::TransformNodeData()
       content_target_id(-1),
       source_node_id(-1),
       needs_local_transform_update(true),
+      transform_changed(false),
       is_invertible(true),
       ancestors_are_invertible(true),
       is_animated(false),
@@ -122,6 +124,7 @@ EffectNodeData::EffectNodeData()
 void TransformTree::clear() {
   PropertyTree<TransformNode>::clear();
 
+  needs_full_update_ = true;
   nodes_affected_by_inner_viewport_bounds_delta_.clear();
   nodes_affected_by_outer_viewport_bounds_delta_.clear();
 }
@@ -203,6 +206,27 @@ void TransformTree::UpdateTransforms(int id) {
   UpdateNodeAndAncestorsHaveIntegerTranslations(node, parent_node);
 }
 
+void TransformTree::UpdateChangedTransforms() {
+  // Parent, target and source nodes are all inserted before the nodes that
+  // depend on them, so a single pass in id order sees their new state.
+  for (int i = 1; i < static_cast<int>(size()); ++i) {
+    TransformNode* node = Node(i);
+    const TransformNode* parent_node = parent(node);
+    const TransformNode* target_node = Node(node->data.target_id);
+    const TransformNode* source_node = Node(node->data.source_node_id);
+    bool needs_update =
+        needs_full_update_ || node->data.needs_local_transform_update ||
+        NeedsSourceToParentUpdate(node) ||
+        (parent_node && parent_node->data.transform_changed) ||
+        (target_node && target_node->data.transform_changed) ||
+        (source_node && source_node->data.transform_changed);
+    node->data.transform_changed = needs_update;
+    if (needs_update)
+      UpdateTransforms(i);
+  }
+  needs_full_update_ = false;
+}
+
 bool TransformTree::IsDescendant(int desc_id, int source_id) const {
   while (desc_id != source_id) {
     if (desc_id < 0)
@@ -575,9 +599,13 @@ void TransformTree::SetDeviceTransformScaleFactor(
       MathUtil::ComputeTransform2dScaleComponents(transform, 1.f);
 
   // Not handling the rare case of different x and y device scale.
-  device_transform_scale_factor_ =
+  float device_transform_scale_factor =
       std::max(device_transform_scale_components.x(),
                device_transform_scale_components.y());
+  if (device_transform_scale_factor_ == device_transform_scale_factor)
+    return;
+  device_transform_scale_factor_ = device_transform_scale_factor;
+  needs_full_update_ = true;
 }
 
 void TransformTree::SetInnerViewportBoundsDelta(gfx::Vector2dF bounds_delta) {
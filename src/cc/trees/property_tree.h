@@ -70,6 +70,11 @@ struct CC_EXPORT TransformNodeData {
   // TODO(vollick): will be moved when accelerated effects are implemented.
   bool needs_local_transform_update : 1;
 
+  // Whether the node was recomputed by the last call to
+  // TransformTree::UpdateChangedTransforms(). Nodes that depend on it have to
+  // be recomputed as well.
+  bool transform_changed : 1;
+
   bool is_invertible : 1;
   bool ancestors_are_invertible : 1;
 
@@ -301,6 +306,18 @@ class CC_EXPORT TransformTree final : public PropertyTree<TransformNode> {
   // Updates the parent, target, and screen space transforms and snapping.
   void UpdateTransforms(int id);
 
+  // Calls UpdateTransforms() on the nodes whose transforms may have changed
+  // since the last call: the nodes that need a local transform update, and
+  // the nodes whose parent, target or source node was updated. After a scroll
+  // or an animation tick, this only visits the affected subtrees.
+  void UpdateChangedTransforms();
+
+  // Whether the next UpdateChangedTransforms() has to update every node, for
+  // changes that are not tracked per node.
+  void set_needs_full_update(bool needs_full_update) {
+    needs_full_update_ = needs_full_update;
+  }
+
   // A TransformNode's source_to_parent value is used to account for the fact
   // that fixed-position layers are positioned by Blink wrt to their layer tree
   // parent (their "source"), but are parented in the transform tree by their
@@ -319,11 +336,16 @@ class CC_EXPORT TransformTree final : public PropertyTree<TransformNode> {
   // We store the page scale factor on the transform tree so that it can be
   // easily be retrieved and updated in UpdatePageScaleInPropertyTrees.
   void set_page_scale_factor(float page_scale_factor) {
+    // Sublayer scales depend on the page scale factor.
+    if (page_scale_factor_ != page_scale_factor)
+      needs_full_update_ = true;
     page_scale_factor_ = page_scale_factor;
   }
   float page_scale_factor() const { return page_scale_factor_; }
 
   void set_device_scale_factor(float device_scale_factor) {
+    if (device_scale_factor_ != device_scale_factor)
+      needs_full_update_ = true;
     device_scale_factor_ = device_scale_factor;
   }
   float device_scale_factor() const { return device_scale_factor_; }
@@ -384,6 +406,7 @@ class CC_EXPORT TransformTree final : public PropertyTree<TransformNode> {
   bool NeedsSourceToParentUpdate(TransformNode* node);
 
   bool source_to_parent_updates_allowed_;
+  bool needs_full_update_;
   // When to_screen transform has perspective, the transform node's sublayer
   // scale is calculated using page scale factor, device scale factor and the
   // scale factor of device transform. So we need to store them explicitly.
@@ -583,6 +583,7 @@ void BuildPropertyTreesTopLevelInternal(
   // combined_clips stored in the clip tree aren't computed during tree
   // building.
   property_trees->transform_tree.set_needs_update(false);
+  property_trees->transform_tree.set_needs_full_update(false);
   property_trees->clip_tree.set_needs_update(true);
   property_trees->effect_tree.set_needs_update(false);
 }
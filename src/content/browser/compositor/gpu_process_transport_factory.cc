@@ -376,6 +376,7 @@ void GpuProcessTransportFactory::EstablishedGpuChannel(
       new cc::SurfaceDisplayOutputSurface(
           manager, compositor->surface_id_allocator(), context_provider,
           shared_worker_context_provider_));
+  display_client->display()->SetTaskGraphRunner(task_graph_runner_.get());
   display_client->set_surface_output_surface(output_surface.get());
   output_surface->set_display_client(display_client.get());
   display_client->display()->Resize(compositor->size());
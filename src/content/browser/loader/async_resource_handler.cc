@@ -118,14 +118,21 @@ void AsyncResourceHandler::OnFollowRedirect(int request_id) {
   ResumeIfDeferred();
 }
 
-void AsyncResourceHandler::OnDataReceivedACK(int request_id) {
-  if (pending_data_count_) {
-    --pending_data_count_;
+void AsyncResourceHandler::OnDataReceivedACK(int request_id,
+                                              int num_messages) {
+  if (num_messages <= 0 || num_messages > pending_data_count_) {
+    DVLOG(1) << "OnDataReceivedACK for " << num_messages << " messages, "
+             << pending_data_count_ << " pending";
+    num_messages = std::min(std::max(num_messages, 0), pending_data_count_);
+  }
+  if (!num_messages)
+    return;
 
+  pending_data_count_ -= num_messages;
+  for (int i = 0; i < num_messages; ++i)
     buffer_->RecycleLeastRecentlyAllocated();
-    if (buffer_->CanAllocate())
-      ResumeIfDeferred();
-  }
+  if (buffer_->CanAllocate())
+    ResumeIfDeferred();
 }
 
 void AsyncResourceHandler::OnUploadProgressACK(int request_id) {
@@ -251,6 +258,8 @@ bool AsyncResourceHandler::OnResponseStarted(ResourceResponse* response,
 
   response->head.request_start = request()->creation_time();
   response->head.response_start = TimeTicks::Now();
+  GetRequestInfo()->RecordLoadStage(
+      ResourceRequestInfoImpl::LOAD_STAGE_RESPONSE_SENT);
   info->filter()->Send(new ResourceMsg_ReceivedResponse(GetRequestID(),
                                                         response->head));
   sent_received_response_msg_ = true;
@@ -54,7 +54,7 @@ class AsyncResourceHandler : public ResourceHandler,
  private:
   // IPC message handlers:
   void OnFollowRedirect(int request_id);
-  void OnDataReceivedACK(int request_id);
+  void OnDataReceivedACK(int request_id, int num_messages);
   void OnUploadProgressACK(int request_id);
 
   void ReportUploadProgress();
@@ -151,6 +151,9 @@ ResourceLoader::~ResourceLoader() {
 }
 
 void ResourceLoader::StartRequest() {
+  GetRequestInfo()->RecordLoadStage(
+      ResourceRequestInfoImpl::LOAD_STAGE_LOADER_STARTED);
+
   if (delegate_->HandleExternalProtocol(this, request_->url())) {
     CancelAndIgnore();
     return;
@@ -343,6 +346,9 @@ void ResourceLoader::OnResponseStarted(net::URLRequest* unused) {
 
   DVLOG(1) << "OnResponseStarted: " << request_->url().spec();
 
+  GetRequestInfo()->RecordLoadStage(
+      ResourceRequestInfoImpl::LOAD_STAGE_RESPONSE_STARTED);
+
   if (!request_->status().is_success()) {
     ResponseCompleted();
     return;
@@ -481,6 +487,8 @@ void ResourceLoader::StartRequestInternal() {
   }
 
   started_request_ = true;
+  GetRequestInfo()->RecordLoadStage(
+      ResourceRequestInfoImpl::LOAD_STAGE_URL_REQUEST_STARTED);
   request_->Start();
 
   delegate_->DidStartRequest(this);
@@ -641,6 +649,8 @@ void ResourceLoader::ResponseCompleted() {
   DVLOG(1) << "ResponseCompleted: " << request_->url().spec();
   RecordHistograms();
   ResourceRequestInfoImpl* info = GetRequestInfo();
+  info->RecordLoadStage(ResourceRequestInfoImpl::LOAD_STAGE_COMPLETED);
+  info->ReportLoadStages(request_->status().is_success());
 
   std::string security_info;
   const net::SSLInfo& ssl_info = request_->ssl_info();
@@ -4,6 +4,11 @@
 
 #include "content/browser/loader/resource_request_info_impl.h"
 
+#include <string>
+
+#include "base/logging.h"
+#include "base/metrics/histogram.h"
+#include "base/trace_event/trace_event.h"
 #include "content/browser/loader/global_routing_id.h"
 #include "content/browser/loader/resource_message_filter.h"
 #include "content/common/net/url_request_user_data.h"
@@ -13,6 +18,24 @@
 
 namespace content {
 
+namespace {
+
+// Names of the ResourceRequestInfoImpl::LoadStage values, used for the trace
+// event steps and the histogram suffixes.
+const char* const kLoadStageNames[] = {
+    "Created",
+    "LoaderStarted",
+    "URLRequestStarted",
+    "ResponseStarted",
+    "ResponseSent",
+    "Completed",
+};
+static_assert(arraysize(kLoadStageNames) ==
+                  ResourceRequestInfoImpl::LOAD_STAGE_COUNT,
+              "kLoadStageNames must cover every LoadStage");
+
+}  // namespace
+
 // ----------------------------------------------------------------------------
 // ResourceRequestInfo
 
@@ -163,6 +186,7 @@ ResourceRequestInfoImpl::ResourceRequestInfoImpl(
       report_raw_headers_(report_raw_headers),
       is_async_(is_async),
       is_using_lofi_(is_using_lofi) {
+  RecordLoadStage(LOAD_STAGE_CREATED);
 }
 
 ResourceRequestInfoImpl::~ResourceRequestInfoImpl() {
@@ -296,4 +320,45 @@ void ResourceRequestInfoImpl::UpdateForTransfer(
   filter_ = filter;
 }
 
+void ResourceRequestInfoImpl::RecordLoadStage(LoadStage stage) {
+  DCHECK_LT(stage, LOAD_STAGE_COUNT);
+  if (load_stage_times_[stage].is_null())
+    load_stage_times_[stage] = base::TimeTicks::Now();
+}
+
+void ResourceRequestInfoImpl::ReportLoadStages(bool success) const {
+  const base::TimeTicks& created = load_stage_times_[LOAD_STAGE_CREATED];
+  TRACE_EVENT_ASYNC_BEGIN_WITH_TIMESTAMP1(
+      "loader", "ResourceLoad", this, created.ToInternalValue(),
+      "request_id", request_id_);
+
+  // Each stage lasts until the next one that was reached. Stages that were
+  // skipped, e.g. by requests that don't go through AsyncResourceHandler, are
+  // folded into the previous one in the trace, but not in the histograms so
+  // that those only ever measure a single stage.
+  int current = LOAD_STAGE_CREATED;
+  for (int next = current + 1; next < LOAD_STAGE_COUNT; ++next) {
+    const base::TimeTicks& next_time = load_stage_times_[next];
+    if (next_time.is_null())
+      continue;
+    TRACE_EVENT_ASYNC_STEP_INTO_WITH_TIMESTAMP0(
+        "loader", "ResourceLoad", this, kLoadStageNames[next],
+        next_time.ToInternalValue());
+    if (success && next == current + 1) {
+      base::HistogramBase* histogram = base::Histogram::FactoryTimeGet(
+          std::string("Net.ResourceLoader.StageTime.") +
+              kLoadStageNames[current],
+          base::TimeDelta::FromMilliseconds(1),
+          base::TimeDelta::FromMinutes(5), 50,
+          base::Histogram::kUmaTargetedHistogramFlag);
+      histogram->AddTime(next_time - load_stage_times_[current]);
+    }
+    current = next;
+  }
+
+  TRACE_EVENT_ASYNC_END_WITH_TIMESTAMP1(
+      "loader", "ResourceLoad", this,
+      load_stage_times_[current].ToInternalValue(), "success", success);
+}
+
 }  // namespace content
@@ -13,6 +13,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/supports_user_data.h"
+#include "base/time/time.h"
 #include "content/public/browser/resource_request_info.h"
 #include "content/public/common/referrer.h"
 #include "content/public/common/resource_type.h"
@@ -31,6 +32,25 @@ struct GlobalRoutingID;
 class ResourceRequestInfoImpl : public ResourceRequestInfo,
                                 public base::SupportsUserData::Data {
  public:
+  // The stages a request goes through in the browser, in order. The time each
+  // stage is first reached is recorded to break down the latency of the load.
+  enum LoadStage {
+    // ResourceDispatcherHostImpl created the request.
+    LOAD_STAGE_CREATED,
+    // ResourceLoader started running the throttles, including the
+    // ResourceScheduler.
+    LOAD_STAGE_LOADER_STARTED,
+    // The throttles let the request through and the net::URLRequest started.
+    LOAD_STAGE_URL_REQUEST_STARTED,
+    // The response headers arrived from the network stack.
+    LOAD_STAGE_RESPONSE_STARTED,
+    // The resource handlers let the response through to the renderer.
+    LOAD_STAGE_RESPONSE_SENT,
+    // The request finished.
+    LOAD_STAGE_COMPLETED,
+    LOAD_STAGE_COUNT,
+  };
+
   // Returns the ResourceRequestInfoImpl associated with the given URLRequest.
   CONTENT_EXPORT static ResourceRequestInfoImpl* ForRequest(
       net::URLRequest* request);
@@ -183,6 +203,20 @@ class ResourceRequestInfoImpl : public ResourceRequestInfo,
     do_not_prompt_for_login_ = do_not_prompt;
   }
 
+  // Records that |stage| was reached now, unless it was reached before, e.g.
+  // before a redirect.
+  void RecordLoadStage(LoadStage stage);
+
+  // Returns when |stage| was first reached, or a null time if it wasn't.
+  base::TimeTicks GetLoadStageTime(LoadStage stage) const {
+    return load_stage_times_[stage];
+  }
+
+  // Emits the recorded stages as a "loader" trace event, and the time spent in
+  // each stage in a Net.ResourceLoader.StageTime.* histogram if |success|.
+  // Called once the request has completed.
+  void ReportLoadStages(bool success) const;
+
  private:
   FRIEND_TEST_ALL_PREFIXES(ResourceDispatcherHostTest,
                            DeletedFilterDetached);
@@ -224,6 +258,7 @@ class ResourceRequestInfoImpl : public ResourceRequestInfo,
   bool report_raw_headers_;
   bool is_async_;
   bool is_using_lofi_;
+  base::TimeTicks load_stage_times_[LOAD_STAGE_COUNT];
 
   DISALLOW_COPY_AND_ASSIGN(ResourceRequestInfoImpl);
 };
@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <set>
 #include <string>
 #include <vector>
@@ -23,6 +24,7 @@
 #include "content/public/browser/resource_throttle.h"
 #include "net/base/host_port_pair.h"
 #include "net/base/load_flags.h"
+#include "net/base/network_quality_estimator.h"
 #include "net/base/request_priority.h"
 #include "net/http/http_server_properties.h"
 #include "net/url_request/url_request.h"
@@ -47,6 +49,9 @@ const char kRequestLimitFieldTrialGroupPrefix[] = "Limit";
 
 const char kResourcePrioritiesFieldTrial[] = "ResourcePriorities";
 
+const char kNetworkQualityFieldTrial[] = "ResourceSchedulerNetworkQuality";
+const char kNetworkQualityFieldTrialEnabled[] = "Enabled";
+
 // Flags identifying various attributes of the request that are used
 // when making scheduling decisions.
 using RequestAttributes = uint8_t;
@@ -98,6 +103,13 @@ static const size_t kMaxNumThrottledRequestsPerClient = 1;
 static const size_t kDefaultMaxNumDelayableWhileLayoutBlocking = 1;
 static const net::RequestPriority
     kDefaultLayoutBlockingPriorityThreshold = net::LOW;
+// Used to size the delayable request limit from the network quality estimate:
+// enough requests of a typical size are let through to cover the
+// bandwidth-delay product, within these bounds.
+static const int64_t kTypicalDelayableResourceBytes = 16 * 1024;
+static const size_t kMinNumDelayableRequestsFromNetworkQuality = 2;
+static const size_t kMaxNumDelayableRequestsFromNetworkQuality = 20;
+static const int kNetworkQualityLimitUpdateIntervalMsec = 1000;
 
 struct ResourceScheduler::RequestPriorityParams {
   RequestPriorityParams()
@@ -377,6 +389,7 @@ class ResourceScheduler::Client {
         scheduler_(scheduler),
         in_flight_delayable_count_(0),
         total_layout_blocking_count_(0),
+        in_flight_requests_deprioritized_(false),
         throttle_state_(ResourceScheduler::THROTTLED) {}
 
   ~Client() {
@@ -418,6 +431,7 @@ class ResourceScheduler::Client {
     // and kMaxNumThrottledRequestsPerClient, so this method must not do
     // anything that depends on those limits before calling
     // ClearInFlightRequests() below.
+    SetInFlightRequestsDeprioritized(false);
     while (!pending_requests_.IsEmpty()) {
       ScheduledResourceRequest* request =
           *pending_requests_.GetNextHighestIterator();
@@ -554,8 +568,11 @@ class ResourceScheduler::Client {
   void ReprioritizeRequest(ScheduledResourceRequest* request,
                            RequestPriorityParams old_priority_params,
                            RequestPriorityParams new_priority_params) {
-    request->url_request()->SetPriority(new_priority_params.priority);
     request->set_request_priority_params(new_priority_params);
+    if (!in_flight_requests_deprioritized_ ||
+        !ShouldDeprioritizeRequest(request)) {
+      request->url_request()->SetPriority(new_priority_params.priority);
+    }
     SetRequestAttributes(request, DetermineRequestAttributes(request));
     if (!pending_requests_.IsQueued(request)) {
       DCHECK(ContainsKey(in_flight_requests_, request));
@@ -594,6 +611,9 @@ class ResourceScheduler::Client {
     if (throttle_state_ != PAUSED) {
       is_paused_ = false;
     }
+    SetInFlightRequestsDeprioritized(
+        scheduler_->use_network_quality() &&
+        (throttle_state_ == THROTTLED || throttle_state_ == COALESCED));
     LoadAnyStartablePendingRequests();
     // TODO(aiolos): Stop any started but not inflght requests when
     // switching to stricter throttle state?
@@ -626,6 +646,33 @@ class ResourceScheduler::Client {
   void InsertInFlightRequest(ScheduledResourceRequest* request) {
     in_flight_requests_.insert(request);
     SetRequestAttributes(request, DetermineRequestAttributes(request));
+    if (in_flight_requests_deprioritized_ && ShouldDeprioritizeRequest(request))
+      request->url_request()->SetPriority(net::IDLE);
+  }
+
+  // Only asynchronous requests yield to other clients. Requests that ignore
+  // limits must stay at MAXIMUM_PRIORITY.
+  bool ShouldDeprioritizeRequest(ScheduledResourceRequest* request) const {
+    return request->is_async() &&
+           !(request->url_request()->load_flags() & net::LOAD_IGNORE_LIMITS);
+  }
+
+  // While a background client yields to loading active clients, its in-flight
+  // requests are lowered to IDLE, so that the layers below (the socket pools,
+  // and HTTP/2 sessions that order streams by priority) serve the active
+  // clients first. They regain their scheduled priority when the client stops
+  // yielding.
+  void SetInFlightRequestsDeprioritized(bool deprioritized) {
+    if (deprioritized == in_flight_requests_deprioritized_)
+      return;
+    in_flight_requests_deprioritized_ = deprioritized;
+    for (ScheduledResourceRequest* request : in_flight_requests_) {
+      if (!ShouldDeprioritizeRequest(request))
+        continue;
+      request->url_request()->SetPriority(
+          deprioritized ? net::IDLE
+                        : request->get_request_priority_params().priority);
+    }
   }
 
   void EraseInFlightRequest(ScheduledResourceRequest* request) {
@@ -717,12 +764,12 @@ class ResourceScheduler::Client {
       // attribute across redirects.
       attributes |= kAttributeLayoutBlocking;
     } else if (!has_html_body_ &&
-               request->url_request()->priority() >
+               request->get_request_priority_params().priority >
                scheduler_->non_delayable_threshold()) {
       // Requests that are above the non_delayable threshold before the HTML
       // body has been parsed are inferred to be layout-blocking.
       attributes |= kAttributeLayoutBlocking;
-    } else if (request->url_request()->priority() <
+    } else if (request->get_request_priority_params().priority <
                scheduler_->non_delayable_threshold()) {
       // Resources below the non_delayable_threshold that are being requested
       // from a server that does not support native prioritization are
@@ -795,7 +842,10 @@ class ResourceScheduler::Client {
   //     request limit in place).
   //   * If no high priority or layout-blocking requests are in flight, start
   //     loading delayable requests.
-  //   * Never exceed 10 delayable requests in flight per client.
+  //   * Never exceed 10 delayable requests in flight per client. With the
+  //     network quality field trial, the limit is instead sized from the
+  //     estimated bandwidth-delay product (2 to 20), and halved for background
+  //     clients while an active client is loading.
   //   * Never exceed 6 delayable requests for a given host.
   //
   //  THROTTLED Clients follow these rules:
@@ -805,6 +855,8 @@ class ResourceScheduler::Client {
   //     THROTTLED Client
   //   * If no high priority requests are in flight, start loading low priority
   //     requests.
+  //   * With the network quality field trial, their in-flight requests are
+  //     lowered to IDLE priority until they are no longer THROTTLED.
   //
   //  COALESCED Clients never load requests, with the following exceptions:
   //   * Non-delayable requests are issued imediately.
@@ -861,8 +913,15 @@ class ResourceScheduler::Client {
     if (!RequestAttributesAreSet(request->attributes(), kAttributeDelayable))
       return START_REQUEST;
 
-    if (in_flight_delayable_count_ >=
-        scheduler_->max_num_delayable_requests()) {
+    size_t max_num_delayable_requests =
+        scheduler_->GetMaxNumDelayableRequests(url_request);
+    if (scheduler_->use_network_quality() && !is_active() &&
+        !scheduler_->active_clients_loaded()) {
+      // Background clients get a smaller share while an active client loads.
+      max_num_delayable_requests =
+          std::max<size_t>(1, max_num_delayable_requests / 2);
+    }
+    if (in_flight_delayable_count_ >= max_num_delayable_requests) {
       return DO_NOT_START_REQUEST_AND_STOP_SEARCHING;
     }
 
@@ -966,6 +1025,9 @@ class ResourceScheduler::Client {
   size_t in_flight_delayable_count_;
   // The number of layout-blocking in-flight requests.
   size_t total_layout_blocking_count_;
+  // True while the in-flight requests are lowered to IDLE, see
+  // SetInFlightRequestsDeprioritized().
+  bool in_flight_requests_deprioritized_;
   ResourceScheduler::ClientThrottleState throttle_state_;
 };
 
@@ -983,6 +1045,9 @@ ResourceScheduler::ResourceScheduler()
       max_num_delayable_while_layout_blocking_(
           kDefaultMaxNumDelayableWhileLayoutBlocking),
       max_num_delayable_requests_(kDefaultMaxNumDelayableRequestsPerClient),
+      use_network_quality_(false),
+      network_quality_delayable_limit_(
+          kDefaultMaxNumDelayableRequestsPerClient),
       coalescing_timer_(new base::Timer(true /* retain_user_task */,
                                         true /* is_repeating */)) {
   std::string throttling_trial_group =
@@ -1043,6 +1108,10 @@ ResourceScheduler::ResourceScheduler()
     if (base::StringToSizeT(resource_priorities_split_group[4], &numeric_value))
       max_num_delayable_requests_ = numeric_value;
   }
+
+  use_network_quality_ =
+      base::FieldTrialList::FindFullName(kNetworkQualityFieldTrial) ==
+      kNetworkQualityFieldTrialEnabled;
 }
 
 ResourceScheduler::~ResourceScheduler() {
@@ -1319,6 +1388,43 @@ void ResourceScheduler::LoadCoalescedRequests() {
   }
 }
 
+size_t ResourceScheduler::GetMaxNumDelayableRequests(
+    const net::URLRequest& url_request) {
+  if (!use_network_quality_)
+    return max_num_delayable_requests_;
+
+  // The estimate changes slowly, and this is called for every pending request
+  // considered, so it is only recomputed periodically. In practice all
+  // scheduled requests share the estimator of the main request context.
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (!network_quality_delayable_limit_time_.is_null() &&
+      now - network_quality_delayable_limit_time_ <
+          base::TimeDelta::FromMilliseconds(
+              kNetworkQualityLimitUpdateIntervalMsec)) {
+    return network_quality_delayable_limit_;
+  }
+  network_quality_delayable_limit_time_ = now;
+  network_quality_delayable_limit_ = max_num_delayable_requests_;
+
+  net::NetworkQualityEstimator* estimator =
+      url_request.context()->network_quality_estimator();
+  base::TimeDelta rtt;
+  int32_t kbps = 0;
+  if (!estimator || !estimator->GetRTTEstimate(&rtt) ||
+      !estimator->GetDownlinkThroughputKbpsEstimate(&kbps) || kbps <= 0) {
+    return network_quality_delayable_limit_;
+  }
+
+  int64_t bandwidth_delay_bytes =
+      static_cast<int64_t>(kbps) * rtt.InMilliseconds() / 8;
+  size_t limit = static_cast<size_t>(bandwidth_delay_bytes /
+                                     kTypicalDelayableResourceBytes);
+  network_quality_delayable_limit_ =
+      std::max(kMinNumDelayableRequestsFromNetworkQuality,
+               std::min(kMaxNumDelayableRequestsFromNetworkQuality, limit));
+  return network_quality_delayable_limit_;
+}
+
 ResourceScheduler::ClientState ResourceScheduler::GetClientState(
     ClientId client_id) const {
   ClientMap::const_iterator client_it = client_map_.find(client_id);
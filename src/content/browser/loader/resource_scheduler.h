@@ -12,6 +12,7 @@
 #include "base/compiler_specific.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time/time.h"
 #include "base/timer/timer.h"
 #include "content/common/content_export.h"
 #include "net/base/priority_queue.h"
@@ -200,6 +201,16 @@ class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
     return max_num_delayable_requests_;
   }
 
+  // Returns true if in-flight limits are sized from the network quality
+  // estimate, and background clients yield to loading active clients.
+  bool use_network_quality() const { return use_network_quality_; }
+
+  // Returns the maximum number of delayable requests a client may have
+  // in-flight. When use_network_quality() is set, it is derived from the
+  // bandwidth-delay product estimated by the NetworkQualityEstimator of
+  // |url_request|'s context, and max_num_delayable_requests() otherwise.
+  size_t GetMaxNumDelayableRequests(const net::URLRequest& url_request);
+
   enum ClientState {
     // Observable client.
     ACTIVE,
@@ -268,6 +279,11 @@ class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
   size_t in_flight_non_delayable_threshold_;
   size_t max_num_delayable_while_layout_blocking_;
   size_t max_num_delayable_requests_;
+  bool use_network_quality_;
+  // The last limit computed by GetMaxNumDelayableRequests() from the network
+  // quality estimate, and when it was computed.
+  size_t network_quality_delayable_limit_;
+  base::TimeTicks network_quality_delayable_limit_time_;
   // This is a repeating timer to initiate requests on COALESCED Clients.
   scoped_ptr<base::Timer> coalescing_timer_;
   RequestSet unowned_requests_;
@@ -152,6 +152,23 @@ void ResourceDispatcher::OnReceivedResponse(
     return;
   request_info->response_start = ConsumeIOTimestamp();
 
+  // Joins the browser side of the load, see
+  // ResourceRequestInfoImpl::ReportLoadStages(), with the time the response
+  // reached this process. Delays that appear negative are due to clock skew
+  // between the processes and are not recorded.
+  if (!response_head.response_start.is_null() &&
+      request_info->response_start >= response_head.response_start) {
+    TRACE_EVENT_ASYNC_BEGIN_WITH_TIMESTAMP0(
+        "loader", "ResourceDispatcher::ResponseDelivery", request_id,
+        response_head.response_start.ToInternalValue());
+    TRACE_EVENT_ASYNC_END_WITH_TIMESTAMP0(
+        "loader", "ResourceDispatcher::ResponseDelivery", request_id,
+        request_info->response_start.ToInternalValue());
+    UMA_HISTOGRAM_TIMES(
+        "ResourceDispatcher.ResponseDeliveryDelay",
+        request_info->response_start - response_head.response_start);
+  }
+
   if (delegate_) {
     RequestPeer* new_peer =
         delegate_->OnReceivedResponse(
@@ -196,7 +213,7 @@ void ResourceDispatcher::OnSetDataBuffer(int request_id,
       new base::SharedMemory(shm_handle, true));  // read only
   request_info->received_data_factory =
       make_scoped_refptr(new SharedMemoryReceivedDataFactory(
-          message_sender_, request_id, request_info->buffer));
+          message_sender_, request_id, request_info->buffer, shm_size));
 
   bool ok = request_info->buffer->Map(shm_size);
   if (!ok) {
@@ -267,7 +284,7 @@ void ResourceDispatcher::OnReceivedData(int request_id,
 
   // Acknowledge the reception of this data.
   if (send_ack)
-    message_sender_->Send(new ResourceHostMsg_DataReceived_ACK(request_id));
+    message_sender_->Send(new ResourceHostMsg_DataReceived_ACK(request_id, 1));
 }
 
 void ResourceDispatcher::OnDownloadedData(int request_id,
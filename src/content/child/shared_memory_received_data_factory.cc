@@ -6,6 +6,7 @@
 
 #include <algorithm>
 
+#include "base/logging.h"
 #include "content/common/resource_messages.h"
 #include "ipc/ipc_sender.h"
 
@@ -46,9 +47,13 @@ class SharedMemoryReceivedDataFactory::SharedMemoryReceivedData final
 SharedMemoryReceivedDataFactory::SharedMemoryReceivedDataFactory(
     IPC::Sender* message_sender,
     int request_id,
-    linked_ptr<base::SharedMemory> memory)
+    linked_ptr<base::SharedMemory> memory,
+    int buffer_size)
     : id_(0),
       oldest_(0),
+      unacked_count_(0),
+      unacked_bytes_(0),
+      ack_threshold_bytes_(buffer_size / 4),
       message_sender_(message_sender),
       request_id_(request_id),
       is_stopped_(false),
@@ -57,7 +62,7 @@ SharedMemoryReceivedDataFactory::SharedMemoryReceivedDataFactory(
 
 SharedMemoryReceivedDataFactory::~SharedMemoryReceivedDataFactory() {
   if (!is_stopped_)
-    SendAck(released_tickets_.size());
+    SendAck(unacked_count_ + released_tickets_.size());
 }
 
 scoped_ptr<RequestPeer::ReceivedData> SharedMemoryReceivedDataFactory::Create(
@@ -67,6 +72,7 @@ scoped_ptr<RequestPeer::ReceivedData> SharedMemoryReceivedDataFactory::Create(
   const char* start = static_cast<char*>(memory_->memory());
   const char* payload = start + offset;
   TicketId id = id_++;
+  outstanding_lengths_.push_back(length);
 
   return make_scoped_ptr(
       new SharedMemoryReceivedData(payload, length, encoded_length, this, id));
@@ -75,6 +81,7 @@ scoped_ptr<RequestPeer::ReceivedData> SharedMemoryReceivedDataFactory::Create(
 void SharedMemoryReceivedDataFactory::Stop() {
   is_stopped_ = true;
   released_tickets_.clear();
+  outstanding_lengths_.clear();
   message_sender_ = nullptr;
 }
 
@@ -101,7 +108,7 @@ void SharedMemoryReceivedDataFactory::Reclaim(TicketId id) {
   }
 
   ++oldest_;
-  SendAck(1);
+  Acknowledge(1);
   if (released_tickets_.empty()) {
     // Fast path: (hopefully) the most typical case.
     return;
@@ -119,13 +126,28 @@ void SharedMemoryReceivedDataFactory::Reclaim(TicketId id) {
   released_tickets_.erase(released_tickets_.begin(),
                           released_tickets_.begin() + count);
   oldest_ += count;
-  SendAck(count);
+  Acknowledge(count);
 }
 
-void SharedMemoryReceivedDataFactory::SendAck(size_t count) {
+void SharedMemoryReceivedDataFactory::Acknowledge(size_t count) {
+  DCHECK_LE(count, outstanding_lengths_.size());
   for (size_t i = 0; i < count; ++i) {
-    message_sender_->Send(new ResourceHostMsg_DataReceived_ACK(request_id_));
+    unacked_bytes_ += outstanding_lengths_.front();
+    outstanding_lengths_.pop_front();
+  }
+  unacked_count_ += count;
+  if (unacked_count_ && unacked_bytes_ >= ack_threshold_bytes_) {
+    SendAck(unacked_count_);
+    unacked_count_ = 0;
+    unacked_bytes_ = 0;
   }
 }
 
+void SharedMemoryReceivedDataFactory::SendAck(size_t count) {
+  if (!count)
+    return;
+  message_sender_->Send(new ResourceHostMsg_DataReceived_ACK(
+      request_id_, static_cast<int>(count)));
+}
+
 }  // namespace content
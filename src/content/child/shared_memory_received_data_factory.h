@@ -5,6 +5,7 @@
 #ifndef CONTENT_CHILD_SHARED_MEMORY_RECEIVED_DATA_FACTORY_H_
 #define CONTENT_CHILD_SHARED_MEMORY_RECEIVED_DATA_FACTORY_H_
 
+#include <deque>
 #include <vector>
 
 #include "base/memory/linked_ptr.h"
@@ -20,12 +21,21 @@ class Sender;
 
 namespace content {
 
+// Issues ReceivedData backed by the shared data buffer of a request, and
+// tells the browser when their parts of the buffer can be reused.
+//
+// The browser only needs to hear back when it is running out of room, so
+// released data is acknowledged in batches: once it adds up to a quarter of
+// the buffer, or when the factory goes away. Since the rest of the buffer
+// remains available to the browser, a batch is always completed before the
+// browser has to wait for it.
 class CONTENT_EXPORT SharedMemoryReceivedDataFactory final
     : public base::RefCounted<SharedMemoryReceivedDataFactory> {
  public:
   SharedMemoryReceivedDataFactory(IPC::Sender* message_sender,
                                   int request_id,
-                                  linked_ptr<base::SharedMemory> memory);
+                                  linked_ptr<base::SharedMemory> memory,
+                                  int buffer_size);
 
   scoped_ptr<RequestPeer::ReceivedData> Create(int offset,
                                                int length,
@@ -47,11 +57,21 @@ class CONTENT_EXPORT SharedMemoryReceivedDataFactory final
   friend class base::RefCounted<SharedMemoryReceivedDataFactory>;
   ~SharedMemoryReceivedDataFactory();
 
+  // Marks the |count| oldest outstanding data as released, and sends an ACK
+  // if enough of them have accumulated.
+  void Acknowledge(size_t count);
   void SendAck(size_t count);
 
   TicketId id_;
   TicketId oldest_;
   std::vector<TicketId> released_tickets_;
+  // The lengths of the issued data that haven't been acknowledged yet, from
+  // |oldest_| on.
+  std::deque<int> outstanding_lengths_;
+  // The released data that the browser hasn't been told about yet.
+  size_t unacked_count_;
+  int unacked_bytes_;
+  const int ack_threshold_bytes_;
   // We assume that |message_sender_| is valid until |Stop| is called.
   IPC::Sender* message_sender_;
   int request_id_;
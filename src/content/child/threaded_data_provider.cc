@@ -327,7 +327,7 @@ void ThreadedDataProvider::ForwardAndACKData(const char* data,
           data_length,
           encoded_data_length));
 
-  ipc_channel_->Send(new ResourceHostMsg_DataReceived_ACK(request_id_));
+  ipc_channel_->Send(new ResourceHostMsg_DataReceived_ACK(request_id_, 1));
 }
 
 void ThreadedDataProvider::DataNotifyForegroundThread(
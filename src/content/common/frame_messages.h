@@ -802,6 +802,7 @@ IPC_MESSAGE_ROUTED1(FrameHostMsg_DidChangeName, std::string /* name */)
 // Sent when the renderer changed the progress of a load.
 IPC_MESSAGE_ROUTED1(FrameHostMsg_DidChangeLoadProgress,
                     double /* load_progress */)
+IPC_MESSAGE_COALESCABLE(FrameHostMsg_DidChangeLoadProgress)
 
 // Requests that the given URL be opened in the specified manner.
 IPC_MESSAGE_ROUTED1(FrameHostMsg_OpenURL, FrameHostMsg_OpenURL_Params)
@@ -387,10 +387,12 @@ IPC_SYNC_MESSAGE_ROUTED2_1(ResourceHostMsg_SyncLoad,
                            ResourceHostMsg_Request,
                            content::SyncLoadResult)
 
-// Sent when the renderer process is done processing a DataReceived
-// message.
-IPC_MESSAGE_CONTROL1(ResourceHostMsg_DataReceived_ACK,
-                     int /* request_id */)
+// Sent when the renderer process is done processing one or more
+// DataReceived messages, in the order they were sent. The browser may reuse
+// the corresponding parts of the shared data buffer.
+IPC_MESSAGE_CONTROL2(ResourceHostMsg_DataReceived_ACK,
+                     int /* request_id */,
+                     int /* num_messages */)
 
 // Sent when the renderer has processed a DataDownloaded message.
 IPC_MESSAGE_CONTROL1(ResourceHostMsg_DataDownloaded_ACK,
@@ -1114,6 +1114,7 @@ IPC_MESSAGE_ROUTED2(ViewHostMsg_FocusedNodeChanged,
                     gfx::Rect /* node_bounds */)
 
 IPC_MESSAGE_ROUTED1(ViewHostMsg_SetCursor, content::WebCursor)
+IPC_MESSAGE_COALESCABLE(ViewHostMsg_SetCursor)
 
 #if defined(OS_WIN)
 IPC_MESSAGE_ROUTED1(ViewHostMsg_WindowlessPluginDummyWindowCreated,
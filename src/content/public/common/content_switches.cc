@@ -380,6 +380,12 @@ const char kEnableGpuMemoryBufferVideoFrames[] =
 // impl-side painting.
 const char kEnableGpuRasterization[]        = "enable-gpu-rasterization";
 
+// Lets requests for a resource that is being written to the HTTP cache read
+// the body as it is written, instead of waiting for the first request to
+// complete.
+const char kEnableHttpCacheStreamingReaders[] =
+    "enable-http-cache-streaming-readers";
+
 // When using CPU rasterizing generate low resolution tiling. Low res
 // tiles may be displayed during fast scrolls especially on slower devices.
 const char kEnableLowResTiling[] = "enable-low-res-tiling";
@@ -452,6 +458,11 @@ const char kEnableSmoothScrolling[]         = "enable-smooth-scrolling";
 // Enable spatial navigation
 const char kEnableSpatialNavigation[]       = "enable-spatial-navigation";
 
+// Serves cached responses that are within their
+// "Cache-Control: stale-while-revalidate" window without waiting for the
+// network, and revalidates them in the background.
+const char kEnableStaleWhileRevalidate[]    = "enable-stale-while-revalidate";
+
 // Enables StatsTable, logging statistics to a global named shared memory table.
 const char kEnableStatsTable[]              = "enable-stats-table";
 
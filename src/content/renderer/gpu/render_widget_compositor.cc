@@ -10,6 +10,7 @@
 #include "base/command_line.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/metrics/field_trial.h"
 #include "base/single_thread_task_runner.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/synchronization/lock.h"
@@ -302,6 +303,8 @@ void RenderWidgetCompositor::Initialize() {
       compositor_deps_->IsElasticOverscrollEnabled();
   settings.renderer_settings.use_gpu_memory_buffer_resources =
       compositor_deps_->IsGpuMemoryBufferCompositorResourcesEnabled();
+  settings.use_skewport_acceleration =
+      base::FieldTrialList::FindFullName("SkewportAcceleration") == "Enabled";
   settings.use_image_texture_targets =
       compositor_deps_->GetImageTextureTargets();
   settings.image_decode_tasks_enabled =
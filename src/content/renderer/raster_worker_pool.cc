@@ -7,6 +7,39 @@
 #include "base/strings/stringprintf.h"
 
 namespace content {
+namespace {
+
+// Tile tasks are scheduled by the compositor with the default category.
+const uint16_t kTileTaskCategory = 0u;
+// Tasks posted via the TaskRunner interfaces. These include media work, e.g.
+// video frame copies, that must not wait behind a backlog of tile tasks.
+const uint16_t kClosureTaskCategory = 1u;
+
+}  // namespace
+
+// A worker thread that runs the tasks of the pool, preferring some categories
+// over others.
+class RasterWorkerPool::RasterWorkerPoolThread : public base::SimpleThread {
+ public:
+  RasterWorkerPoolThread(const std::string& name_prefix,
+                         const Options& options,
+                         cc::TaskGraphRunner* task_graph_runner,
+                         const std::vector<uint16_t>& categories)
+      : SimpleThread(name_prefix, options),
+        task_graph_runner_(task_graph_runner),
+        categories_(categories) {}
+
+  // Overridden from base::SimpleThread:
+  void Run() override {
+    task_graph_runner_->RunTasksForCategories(categories_);
+  }
+
+ private:
+  cc::TaskGraphRunner* const task_graph_runner_;
+  const std::vector<uint16_t> categories_;
+
+  DISALLOW_COPY_AND_ASSIGN(RasterWorkerPoolThread);
+};
 
 // A sequenced task runner which posts tasks to a RasterWorkerPool.
 class RasterWorkerPool::RasterWorkerPoolSequencedTaskRunner
@@ -44,7 +77,8 @@ class RasterWorkerPool::RasterWorkerPoolSequencedTaskRunner
       if (!graph_.nodes.empty())
         dependencies = 1;
 
-      cc::TaskGraph::Node node(graph_task.get(), 0, dependencies);
+      cc::TaskGraph::Node node(graph_task.get(), kClosureTaskCategory, 0,
+                               dependencies);
       if (dependencies) {
         graph_.edges.push_back(
             cc::TaskGraph::Edge(graph_.nodes.back().task, node.task));
@@ -86,13 +120,23 @@ void RasterWorkerPool::Start(
     int num_threads,
     const base::SimpleThread::Options& thread_options) {
   DCHECK(threads_.empty());
+  std::vector<uint16_t> closures_first;
+  closures_first.push_back(kClosureTaskCategory);
+  closures_first.push_back(kTileTaskCategory);
+  std::vector<uint16_t> tiles_first(closures_first.rbegin(),
+                                    closures_first.rend());
   while (threads_.size() < static_cast<size_t>(num_threads)) {
-    scoped_ptr<base::DelegateSimpleThread> thread(
-        new base::DelegateSimpleThread(
-            this, base::StringPrintf("CompositorTileWorker%u",
-                                     static_cast<unsigned>(threads_.size() + 1))
-                      .c_str(),
-            thread_options));
+    // Every thread runs both kinds of tasks, so closures are never starved by
+    // tile work. With more than one thread, the first thread prefers tile
+    // tasks, so that raster keeps progressing while closures keep the other
+    // threads busy. A single thread prefers closures, which are short and
+    // would otherwise wait behind every queued tile task.
+    bool prefer_tiles = threads_.empty() && num_threads > 1;
+    scoped_ptr<base::SimpleThread> thread(new RasterWorkerPoolThread(
+        base::StringPrintf("CompositorTileWorker%u",
+                           static_cast<unsigned>(threads_.size() + 1)),
+        thread_options, &task_graph_runner_,
+        prefer_tiles ? tiles_first : closures_first));
     thread->Start();
     threads_.push_back(thread.Pass());
   }
@@ -130,8 +174,10 @@ bool RasterWorkerPool::PostDelayedTask(
 
   tasks_.push_back(make_scoped_refptr(new ClosureTask(task)));
   graph_.Reset();
-  for (const auto& graph_task : tasks_)
-    graph_.nodes.push_back(cc::TaskGraph::Node(graph_task.get(), 0, 0));
+  for (const auto& graph_task : tasks_) {
+    graph_.nodes.push_back(
+        cc::TaskGraph::Node(graph_task.get(), kClosureTaskCategory, 0, 0));
+  }
 
   task_graph_runner_.ScheduleTasks(namespace_token_, &graph_);
   completed_tasks_.clear();
@@ -142,11 +188,6 @@ bool RasterWorkerPool::RunsTasksOnCurrentThread() const {
   return true;
 }
 
-// Overridden from base::DelegateSimpleThread::Delegate:
-void RasterWorkerPool::Run() {
-  task_graph_runner_.Run();
-}
-
 scoped_refptr<base::SequencedTaskRunner>
 RasterWorkerPool::CreateSequencedTaskRunner() {
   return new RasterWorkerPoolSequencedTaskRunner(&task_graph_runner_);
@@ -24,11 +24,13 @@ namespace content {
 // parallel with other instances of sequenced task runners.
 // It's also possible to get the underlying TaskGraphRunner to schedule a graph
 // of tasks with their dependencies.
+// Tasks posted via the TaskRunner interfaces, which include media work, run
+// ahead of tile tasks on every thread but the first. When there is more than
+// one thread, the first thread prefers tile tasks, so that rasterization keeps
+// progressing under a flood of posted tasks.
 // TODO(reveman): make TaskGraphRunner an abstract interface and have this
 // WorkerPool class implement it.
-class CONTENT_EXPORT RasterWorkerPool
-    : public base::TaskRunner,
-      public base::DelegateSimpleThread::Delegate {
+class CONTENT_EXPORT RasterWorkerPool : public base::TaskRunner {
  public:
   RasterWorkerPool();
 
@@ -38,9 +40,6 @@ class CONTENT_EXPORT RasterWorkerPool
                        base::TimeDelta delay) override;
   bool RunsTasksOnCurrentThread() const override;
 
-  // Overridden from base::DelegateSimpleThread::Delegate:
-  void Run() override;
-
   // Spawn |num_threads| number of threads and start running work on the
   // worker threads.
   void Start(int num_threads,
@@ -63,6 +62,7 @@ class CONTENT_EXPORT RasterWorkerPool
  private:
   class RasterWorkerPoolSequencedTaskRunner;
   friend class RasterWorkerPoolSequencedTaskRunner;
+  class RasterWorkerPoolThread;
 
   // Simple Task for the TaskGraphRunner that wraps a closure.
   // This class is used to schedule TaskRunner tasks on the
@@ -84,7 +84,7 @@ class CONTENT_EXPORT RasterWorkerPool
   };
 
   // The actual threads where work is done.
-  ScopedVector<base::DelegateSimpleThread> threads_;
+  ScopedVector<base::SimpleThread> threads_;
   cc::TaskGraphRunner task_graph_runner_;
 
   // Lock to exclusively access all the following members that are used to
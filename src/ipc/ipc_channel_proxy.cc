@@ -32,6 +32,8 @@ ChannelProxy::Context::Context(
       channel_connected_called_(false),
       channel_send_thread_safe_(false),
       message_filter_router_(new MessageFilterRouter()),
+      dequeued_event_count_(0),
+      dispatch_task_pending_(false),
       peer_pid_(base::kNullProcessId),
       attachment_broker_endpoint_(false) {
   DCHECK(ipc_task_runner_.get());
@@ -47,8 +49,14 @@ ChannelProxy::Context::Context(
 }
 
 ChannelProxy::Context::~Context() {
+  for (size_t i = 0; i < incoming_events_.size(); ++i)
+    delete incoming_events_[i].message;
 }
 
+ChannelProxy::Context::QueuedEvent::QueuedEvent() : message(NULL) {}
+
+ChannelProxy::Context::QueuedEvent::~QueuedEvent() {}
+
 void ChannelProxy::Context::ClearIPCTaskRunner() {
   ipc_task_runner_ = NULL;
 }
@@ -72,8 +80,8 @@ bool ChannelProxy::Context::TryFilters(const Message& message) {
 
   if (message_filter_router_->TryFilters(message)) {
     if (message.dispatch_error()) {
-      listener_task_runner_->PostTask(
-          FROM_HERE, base::Bind(&Context::OnDispatchBadMessage, this, message));
+      QueueNotification(base::Bind(&Context::OnDispatchBadMessage,
+                                   base::Unretained(this), message));
     }
 #ifdef IPC_MESSAGE_LOG_ENABLED
     if (logger->Enabled())
@@ -94,11 +102,58 @@ bool ChannelProxy::Context::OnMessageReceived(const Message& message) {
 
 // Called on the IPC::Channel thread
 bool ChannelProxy::Context::OnMessageReceivedNoFilter(const Message& message) {
-  listener_task_runner_->PostTask(
-      FROM_HERE, base::Bind(&Context::OnDispatchMessage, this, message));
+  bool coalescable =
+      !message.is_sync() && Message::IsCoalescableType(message.type());
+  {
+    base::AutoLock auto_lock(incoming_messages_lock_);
+    size_t sequence_number = dequeued_event_count_ + incoming_events_.size();
+    if (coalescable) {
+      std::pair<std::map<std::pair<int32_t, uint32_t>, size_t>::iterator,
+                bool>
+          result = coalescable_messages_.insert(std::make_pair(
+              std::make_pair(message.routing_id(), message.type()),
+              sequence_number));
+      if (!result.second) {
+        // Drops the previous instance if it is still queued, rather than
+        // replacing it in place, so that the new one is still dispatched
+        // after the messages that were received before it.
+        if (result.first->second >= dequeued_event_count_) {
+          size_t index = result.first->second - dequeued_event_count_;
+          delete incoming_events_[index].message;
+          incoming_events_[index].message = NULL;
+        }
+        result.first->second = sequence_number;
+      }
+    }
+    incoming_events_.push_back(QueuedEvent());
+    incoming_events_.back().message = new Message(message);
+    if (dispatch_task_pending_)
+      return true;
+    dispatch_task_pending_ = true;
+  }
+  PostDispatchTask();
   return true;
 }
 
+// Called on the IPC::Channel thread
+void ChannelProxy::Context::QueueNotification(
+    const base::Closure& notification) {
+  {
+    base::AutoLock auto_lock(incoming_messages_lock_);
+    incoming_events_.push_back(QueuedEvent());
+    incoming_events_.back().notification = notification;
+    if (dispatch_task_pending_)
+      return;
+    dispatch_task_pending_ = true;
+  }
+  PostDispatchTask();
+}
+
+void ChannelProxy::Context::PostDispatchTask() {
+  listener_task_runner_->PostTask(
+      FROM_HERE, base::Bind(&Context::OnDispatchQueuedMessages, this));
+}
+
 // Called on the IPC::Channel thread
 void ChannelProxy::Context::OnChannelConnected(int32_t peer_pid) {
   // We cache off the peer_pid so it can be safely accessed from both threads.
@@ -120,9 +175,9 @@ void ChannelProxy::Context::OnChannelError() {
   for (size_t i = 0; i < filters_.size(); ++i)
     filters_[i]->OnChannelError();
 
-  // See above comment about using listener_task_runner_ here.
-  listener_task_runner_->PostTask(
-      FROM_HERE, base::Bind(&Context::OnDispatchError, this));
+  // The error is delivered after the messages received before it.
+  QueueNotification(
+      base::Bind(&Context::OnDispatchError, base::Unretained(this)));
 }
 
 // Called on the IPC::Channel thread
@@ -298,6 +353,50 @@ void ChannelProxy::Context::OnDispatchMessage(const Message& message) {
 #endif
 }
 
+// Called on the listener's thread
+void ChannelProxy::Context::OnDispatchQueuedMessages() {
+  size_t queued_count;
+  {
+    base::AutoLock auto_lock(incoming_messages_lock_);
+    dispatch_task_pending_ = false;
+    queued_count = incoming_events_.size();
+  }
+  TRACE_EVENT1("ipc", "ChannelProxy::Context::OnDispatchQueuedMessages",
+               "count", queued_count);
+
+  // Events are taken off the shared queue one at a time. If a listener
+  // spins a nested message loop, e.g. for a sync message or a modal dialog,
+  // the task posted below dispatches the rest of the queue from there, still
+  // in order. Channel errors and bad message notifications go through the
+  // same queue, so the task can't run them ahead of earlier messages.
+  for (;;) {
+    scoped_ptr<Message> message;
+    base::Closure notification;
+    bool post_task = false;
+    {
+      base::AutoLock auto_lock(incoming_messages_lock_);
+      if (incoming_events_.empty()) {
+        coalescable_messages_.clear();
+        return;
+      }
+      message.reset(incoming_events_.front().message);
+      notification = incoming_events_.front().notification;
+      incoming_events_.pop_front();
+      ++dequeued_event_count_;
+      if (!incoming_events_.empty() && !dispatch_task_pending_) {
+        dispatch_task_pending_ = true;
+        post_task = true;
+      }
+    }
+    if (post_task)
+      PostDispatchTask();
+    if (message)
+      OnDispatchMessage(*message);
+    else if (!notification.is_null())
+      notification.Run();
+  }
+}
+
 // Called on the listener's thread
 void ChannelProxy::Context::OnDispatchConnected() {
   if (channel_connected_called_)
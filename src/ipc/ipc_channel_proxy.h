@@ -5,8 +5,12 @@
 #ifndef IPC_IPC_CHANNEL_PROXY_H_
 #define IPC_IPC_CHANNEL_PROXY_H_
 
+#include <deque>
+#include <map>
+#include <utility>
 #include <vector>
 
+#include "base/callback.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/synchronization/lock.h"
@@ -231,6 +235,7 @@ class IPC_EXPORT ChannelProxy : public Endpoint, public base::NonThreadSafe {
 
     // Methods called on the listener thread.
     void AddFilter(MessageFilter* filter);
+    void OnDispatchQueuedMessages();
     void OnDispatchConnected();
     void OnDispatchError();
     void OnDispatchBadMessage(const Message& message);
@@ -270,6 +275,44 @@ class IPC_EXPORT ChannelProxy : public Endpoint, public base::NonThreadSafe {
     // Lock for pending_filters_.
     base::Lock pending_filters_lock_;
 
+    // A message received on the IPC thread, or a notification for the
+    // listener, waiting to be dispatched on the listener thread.
+    struct QueuedEvent {
+      QueuedEvent();
+      ~QueuedEvent();
+
+      // Owned. Null for notifications, and for coalescable messages
+      // superseded by a later instance.
+      Message* message;
+      // Set for notifications (channel error, bad message handled by a
+      // filter), which are queued rather than posted so that they can't
+      // overtake the messages received before them.
+      base::Closure notification;
+    };
+
+    // Queues |notification| behind the messages already queued.
+    void QueueNotification(const base::Closure& notification);
+
+    // Posts OnDispatchQueuedMessages() unless it is already pending. Must be
+    // called without |incoming_messages_lock_| held, after queueing an event
+    // with |dispatch_task_pending_| found false and set.
+    void PostDispatchTask();
+
+    // Events waiting to be dispatched on the listener thread, in arrival
+    // order. They are dispatched one at a time by OnDispatchQueuedMessages(),
+    // which is posted when the first one is queued.
+    std::deque<QueuedEvent> incoming_events_;
+    // The number of events taken off the front of |incoming_events_|.
+    size_t dequeued_event_count_;
+    // Sequence number, i.e. the number of events queued before it, of the
+    // latest instance of each coalescable message, keyed by routing ID and
+    // type.
+    std::map<std::pair<int32_t, uint32_t>, size_t> coalescable_messages_;
+    // Whether an OnDispatchQueuedMessages() task is posted but not running.
+    bool dispatch_task_pending_;
+    // Lock for the four above.
+    base::Lock incoming_messages_lock_;
+
     // Cached copy of the peer process ID. Set on IPC but read on both IPC and
     // listener threads.
     base::ProcessId peer_pid_;
@@ -7,6 +7,7 @@
 #include <limits.h>
 
 #include "base/atomic_sequence_num.h"
+#include "base/atomicops.h"
 #include "base/logging.h"
 #include "build/build_config.h"
 #include "ipc/attachment_broker.h"
@@ -38,6 +39,13 @@ inline uint32_t GetRefNumUpper24() {
   return ((pid << 14) | (count & 0x3fff)) << 8;
 }
 
+// Message types registered with IPC_MESSAGE_COALESCABLE(), in an open
+// addressing hash table so that the IPC thread can look them up for every
+// incoming message without taking a lock. Empty slots are zero, which is not
+// a valid message type.
+const size_t kMaxCoalescableTypes = 256;
+base::subtle::Atomic32 g_coalescable_types[kMaxCoalescableTypes];
+
 }  // namespace
 
 namespace IPC {
@@ -113,6 +121,35 @@ void Message::SetHeaderValues(int32_t routing, uint32_t type, uint32_t flags) {
   header()->flags = flags;
 }
 
+// static
+void Message::RegisterCoalescableType(uint32_t type) {
+  DCHECK(type);
+  base::subtle::Atomic32 value = static_cast<base::subtle::Atomic32>(type);
+  for (size_t i = 0; i < kMaxCoalescableTypes; ++i) {
+    size_t slot = (type + i) % kMaxCoalescableTypes;
+    base::subtle::Atomic32 previous = base::subtle::Release_CompareAndSwap(
+        &g_coalescable_types[slot], 0, value);
+    if (!previous || previous == value)
+      return;
+  }
+  LOG(DFATAL) << "Too many coalescable message types";
+}
+
+// static
+bool Message::IsCoalescableType(uint32_t type) {
+  base::subtle::Atomic32 value = static_cast<base::subtle::Atomic32>(type);
+  for (size_t i = 0; i < kMaxCoalescableTypes; ++i) {
+    size_t slot = (type + i) % kMaxCoalescableTypes;
+    base::subtle::Atomic32 stored =
+        base::subtle::Acquire_Load(&g_coalescable_types[slot]);
+    if (!stored)
+      return false;
+    if (stored == value)
+      return true;
+  }
+  return false;
+}
+
 void Message::EnsureMessageAttachmentSet() {
   if (attachment_set_.get() == NULL)
     attachment_set_ = new MessageAttachmentSet;
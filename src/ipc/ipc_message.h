@@ -149,6 +149,13 @@ class IPC_EXPORT Message : public base::Pickle {
   // call.
   void SetHeaderValues(int32_t routing, uint32_t type, uint32_t flags);
 
+  // Marks messages of |type| as coalescable: while they are queued for
+  // dispatch by a ChannelProxy, only the latest one per routing ID is kept.
+  // Use IPC_MESSAGE_COALESCABLE() in the message declaration instead of
+  // calling this directly.
+  static void RegisterCoalescableType(uint32_t type);
+  static bool IsCoalescableType(uint32_t type);
+
   template<class T, class S, class P>
   static bool Dispatch(const Message* msg, T* obj, S* sender, P* parameter,
                        void (T::*func)()) {
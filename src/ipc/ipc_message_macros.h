@@ -182,6 +182,15 @@
 // Receiver stashes the IPC::Message* pointer, and when it's ready, it does:
 //     ViewHostMsg_SyncMessageName::WriteReplyParams(reply_msg, out1, out2);
 //     Send(reply_msg);
+//
+// Asynchronous messages that only carry the latest state of something (e.g.
+// a position or a progress update) can be marked as coalescable after their
+// declaration:
+//     IPC_MESSAGE_ROUTED1(ViewHostMsg_Progress, double /* progress */)
+//     IPC_MESSAGE_COALESCABLE(ViewHostMsg_Progress)
+// While such messages wait on the IPC thread to be dispatched by a
+// ChannelProxy, only the latest one per routing ID is kept. Messages that
+// the receiver has to see every instance of must not be marked this way.
 
 // Files that want to export their ipc messages should do
 //   #undef IPC_MESSAGE_EXPORT
@@ -678,6 +687,18 @@
   IPC_##sync##_##kind##_IMPL(msg_class, in_cnt, out_cnt, in_list, out_list)   \
   IPC_##sync##_MESSAGE_LOG(msg_class)
 
+// Registers the message type when the generated code is loaded, like the
+// logging registration below.
+#define IPC_MESSAGE_COALESCABLE(msg_class)                                    \
+  class CoalescableRegisterHelper##msg_class {                                \
+   public:                                                                    \
+    CoalescableRegisterHelper##msg_class() {                                  \
+      IPC::Message::RegisterCoalescableType(                                  \
+          static_cast<uint32_t>(msg_class::ID));                              \
+    }                                                                         \
+  };                                                                          \
+  CoalescableRegisterHelper##msg_class g_CoalescableRegisterHelper##msg_class;
+
 #define IPC_EMPTY_CONTROL_IMPL(msg_class, in_cnt, out_cnt, in_list, out_list)
 #define IPC_EMPTY_ROUTED_IMPL(msg_class, in_cnt, out_cnt, in_list, out_list)
 
@@ -801,12 +822,16 @@
   };                                                                    \
   LoggerRegisterHelper##msg_class g_LoggerRegisterHelper##msg_class;
 
+#define IPC_MESSAGE_COALESCABLE(msg_class)
+
 #else
 
 // Normal inclusion produces nothing extra.
 #define IPC_MESSAGE_EXTRA(sync, kind, msg_class,                \
                           in_cnt, out_cnt, in_list, out_list)
 
+#define IPC_MESSAGE_COALESCABLE(msg_class)
+
 #endif // defined(IPC_MESSAGE_IMPL)
 
 // Handle variable sized argument lists.  These are usually invoked by token
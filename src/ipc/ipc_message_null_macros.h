@@ -15,6 +15,7 @@
 #undef IPC_STRUCT_TRAITS_END
 #undef IPC_ENUM_TRAITS_VALIDATE
 #undef IPC_MESSAGE_DECL
+#undef IPC_MESSAGE_COALESCABLE
 
 #define IPC_STRUCT_BEGIN_WITH_PARENT(struct_name, parent)
 #define IPC_STRUCT_MEMBER(type, name, ...)
@@ -26,4 +27,5 @@
 #define IPC_ENUM_TRAITS_VALIDATE(enum_name, validation_expression)
 #define IPC_MESSAGE_DECL(sync, kind, msg_class, \
                          in_cnt, out_cnt, in_list, out_list)
+#define IPC_MESSAGE_COALESCABLE(msg_class)
 
@@ -38,6 +38,12 @@ class MOJO_SYSTEM_IMPL_EXPORT MessageInTransitQueue {
   const MessageInTransit* PeekMessage() const { return queue_.front(); }
   MessageInTransit* PeekMessage() { return queue_.front(); }
 
+  // Returns the |index|-th message from the front. |index| must be less than
+  // |Size()|.
+  const MessageInTransit* PeekMessageAt(size_t index) const {
+    return queue_[index];
+  }
+
   void DiscardMessage() {
     delete queue_.front();
     queue_.pop_front();
@@ -22,6 +22,11 @@ namespace edk {
 
 const size_t kReadSize = 4096;
 
+// Limits on how much |WriteBuffer::GetBuffers()| gathers for a single write.
+// 16 buffers is well below IOV_MAX everywhere.
+const size_t kMaxGatheredWriteBuffers = 16;
+const size_t kMaxGatheredWriteBytes = 64 * 1024;
+
 // RawChannel::ReadBuffer ------------------------------------------------------
 
 RawChannel::ReadBuffer::ReadBuffer() : buffer_(kReadSize), num_valid_bytes_(0) {
@@ -98,63 +103,120 @@ void RawChannel::WriteBuffer::GetPlatformHandlesToSend(
 }
 
 void RawChannel::WriteBuffer::GetBuffers(std::vector<Buffer>* buffers) {
+  GetFrontMessageBuffers(buffers);
+
+  // Gathers the following messages, up to limits on the number of buffers and
+  // bytes, so that a single write covers them. Platform handles are only sent
+  // for the front message, so stop before any other message that has some.
+  size_t num_bytes = 0;
+  for (size_t i = 0; i < buffers->size(); ++i)
+    num_bytes += (*buffers)[i].size;
+  for (size_t i = 1; i < message_queue_.Size(); ++i) {
+    const MessageInTransit* message = message_queue_.PeekMessageAt(i);
+    const TransportData* transport_data = message->transport_data();
+    if (transport_data && transport_data->platform_handles() &&
+        !transport_data->platform_handles()->empty()) {
+      break;
+    }
+    if (buffers->size() + 2 > kMaxGatheredWriteBuffers ||
+        num_bytes + message->total_size() > kMaxGatheredWriteBytes) {
+      break;
+    }
+    AppendMessageBuffers(message, GetInitialDataOffset(message), buffers);
+    num_bytes += message->total_size() - GetInitialDataOffset(message);
+  }
+}
+
+void RawChannel::WriteBuffer::GetFrontMessageBuffers(
+    std::vector<Buffer>* buffers) {
   buffers->clear();
 
   if (message_queue_.IsEmpty())
     return;
 
   const MessageInTransit* message = message_queue_.PeekMessage();
-  if (message->type() == MessageInTransit::Type::RAW_MESSAGE) {
-    // These are already-serialized messages so we don't want to write another
-    // header as they include that.
-    if (data_offset_ == 0) {
-      size_t header_size = message->total_size() - message->num_bytes();
-      data_offset_ = header_size;
-    }
+  if (data_offset_ == 0)
+    data_offset_ = GetInitialDataOffset(message);
+  AppendMessageBuffers(message, data_offset_, buffers);
+}
+
+RawChannel::WriteBuffer::Buffer RawChannel::WriteBuffer::CoalesceBuffers(
+    const std::vector<Buffer>& buffers,
+    size_t max_size) {
+  DCHECK(!buffers.empty());
+  size_t num_buffers = 1;
+  size_t size = buffers[0].size;
+  while (num_buffers < buffers.size() &&
+         size + buffers[num_buffers].size <= max_size) {
+    size += buffers[num_buffers].size;
+    num_buffers++;
+  }
+  if (num_buffers == 1)
+    return buffers[0];
+
+  coalesced_buffer_.resize(size);
+  size_t offset = 0;
+  for (size_t i = 0; i < num_buffers; ++i) {
+    memcpy(&coalesced_buffer_[offset], buffers[i].addr, buffers[i].size);
+    offset += buffers[i].size;
   }
+  Buffer buffer = {&coalesced_buffer_[0], size};
+  return buffer;
+}
+
+// static
+size_t RawChannel::WriteBuffer::GetInitialDataOffset(
+    const MessageInTransit* message) {
+  // These are already-serialized messages so we don't want to write another
+  // header as they include that.
+  if (message->type() == MessageInTransit::Type::RAW_MESSAGE)
+    return message->total_size() - message->num_bytes();
+  return 0;
+}
 
-  DCHECK_LT(data_offset_, message->total_size());
-  size_t bytes_to_write = message->total_size() - data_offset_;
+// static
+void RawChannel::WriteBuffer::AppendMessageBuffers(
+    const MessageInTransit* message,
+    size_t data_offset,
+    std::vector<Buffer>* buffers) {
+  DCHECK_LT(data_offset, message->total_size());
+  size_t bytes_to_write = message->total_size() - data_offset;
 
   size_t transport_data_buffer_size =
       message->transport_data() ? message->transport_data()->buffer_size() : 0;
 
   if (!transport_data_buffer_size) {
     // Only write from the main buffer.
-    DCHECK_LT(data_offset_, message->main_buffer_size());
+    DCHECK_LT(data_offset, message->main_buffer_size());
     DCHECK_LE(bytes_to_write, message->main_buffer_size());
     Buffer buffer = {
-        static_cast<const char*>(message->main_buffer()) + data_offset_,
+        static_cast<const char*>(message->main_buffer()) + data_offset,
         bytes_to_write};
 
     buffers->push_back(buffer);
     return;
   }
 
-  if (data_offset_ >= message->main_buffer_size()) {
+  if (data_offset >= message->main_buffer_size()) {
     // Only write from the transport data buffer.
-    DCHECK_LT(data_offset_ - message->main_buffer_size(),
+    DCHECK_LT(data_offset - message->main_buffer_size(),
               transport_data_buffer_size);
     DCHECK_LE(bytes_to_write, transport_data_buffer_size);
     Buffer buffer = {
         static_cast<const char*>(message->transport_data()->buffer()) +
-            (data_offset_ - message->main_buffer_size()),
+            (data_offset - message->main_buffer_size()),
         bytes_to_write};
 
     buffers->push_back(buffer);
     return;
   }
 
-  // TODO(vtl): We could actually send out buffers from multiple messages, with
-  // the "stopping" condition being reaching a message with platform handles
-  // attached.
-
   // Write from both buffers.
-  DCHECK_EQ(bytes_to_write, message->main_buffer_size() - data_offset_ +
+  DCHECK_EQ(bytes_to_write, message->main_buffer_size() - data_offset +
                                 transport_data_buffer_size);
   Buffer buffer1 = {
-      static_cast<const char*>(message->main_buffer()) + data_offset_,
-      message->main_buffer_size() - data_offset_};
+      static_cast<const char*>(message->main_buffer()) + data_offset,
+      message->main_buffer_size() - data_offset};
   buffers->push_back(buffer1);
   Buffer buffer2 = {
       static_cast<const char*>(message->transport_data()->buffer()),
@@ -514,12 +576,14 @@ void RawChannel::SerializeWriteBuffer(
   while (!write_buffer_->message_queue_.IsEmpty()) {
     SerializePlatformHandles(fds);
     std::vector<WriteBuffer::Buffer> buffers;
-    write_buffer_no_lock()->GetBuffers(&buffers);
+    write_buffer_no_lock()->GetFrontMessageBuffers(&buffers);
     for (size_t i = 0; i < buffers.size(); ++i) {
       buffer->insert(buffer->end(), buffers[i].addr,
                      buffers[i].addr + buffers[i].size);
     }
     write_buffer_->message_queue_.DiscardMessage();
+    write_buffer_->platform_handles_offset_ = 0;
+    write_buffer_->data_offset_ = 0;
   }
 }
 
@@ -704,13 +768,25 @@ void RawChannel::UpdateWriteBuffer(size_t platform_handles_written,
   write_buffer_->platform_handles_offset_ += platform_handles_written;
   write_buffer_->data_offset_ += bytes_written;
 
-  MessageInTransit* message = write_buffer_->message_queue_.PeekMessage();
-  if (write_buffer_->data_offset_ >= message->total_size()) {
+  // A gathering write may have completed several messages, and part of the
+  // next one.
+  while (true) {
+    MessageInTransit* message = write_buffer_->message_queue_.PeekMessage();
+    if (write_buffer_->data_offset_ < message->total_size())
+      break;
+
     // Complete write.
-    CHECK_EQ(write_buffer_->data_offset_, message->total_size());
+    size_t excess_bytes = write_buffer_->data_offset_ - message->total_size();
     write_buffer_->message_queue_.DiscardMessage();
     write_buffer_->platform_handles_offset_ = 0;
     write_buffer_->data_offset_ = 0;
+    if (!excess_bytes)
+      break;
+    CHECK(!write_buffer_->message_queue_.IsEmpty());
+    write_buffer_->data_offset_ =
+        WriteBuffer::GetInitialDataOffset(
+            write_buffer_->message_queue_.PeekMessage()) +
+        excess_bytes;
   }
 }
 
@@ -209,16 +209,36 @@ class MOJO_SYSTEM_IMPL_EXPORT RawChannel {
                                   void** serialization_data);
 
     // Gets buffers to be written. These buffers will always come from the front
-    // of |message_queue_|. Once they are completely written, the front
-    // |MessageInTransit| should be popped (and destroyed); this is done in
+    // of |message_queue_|. To let the implementation write several messages
+    // with a single gathering write, they may span several messages, stopping
+    // before the next one with platform handles attached. Once messages are
+    // completely written, they are popped (and destroyed); this is done in
     // |OnWriteCompletedInternalNoLock()|.
     void GetBuffers(std::vector<Buffer>* buffers);
 
+    // Like |GetBuffers()|, but only for the front message.
+    void GetFrontMessageBuffers(std::vector<Buffer>* buffers);
+
+    // For implementations that can only write from one buffer at a time:
+    // copies as many of |buffers| (from the front) as fit in |max_size| bytes
+    // into a buffer owned by this object, which stays valid until the next
+    // call. If only the first buffer fits, it is returned as is.
+    Buffer CoalesceBuffers(const std::vector<Buffer>& buffers, size_t max_size);
+
     bool IsEmpty() const { return message_queue_.IsEmpty(); }
 
    private:
     friend class RawChannel;
 
+    // Returns the offset in |message| at which writing it starts. Raw
+    // (already-serialized) messages are written without their header.
+    static size_t GetInitialDataOffset(const MessageInTransit* message);
+
+    // Appends the buffers of |message| to write, starting at |data_offset|.
+    static void AppendMessageBuffers(const MessageInTransit* message,
+                                     size_t data_offset,
+                                     std::vector<Buffer>* buffers);
+
     size_t serialized_platform_handle_size_;
 
     MessageInTransitQueue message_queue_;
@@ -231,6 +251,9 @@ class MOJO_SYSTEM_IMPL_EXPORT RawChannel {
     // write.
     size_t data_offset_;
 
+    // Backing store for |CoalesceBuffers()|.
+    std::vector<char> coalesced_buffer_;
+
     MOJO_DISALLOW_COPY_AND_ASSIGN(WriteBuffer);
   };
 
@@ -403,6 +426,8 @@ class MOJO_SYSTEM_IMPL_EXPORT RawChannel {
   // channel.
   void DispatchMessages(bool* did_dispatch_message, bool* stop_dispatching);
 
+  // Advances the write buffer past what was written, popping any messages
+  // that were completely written.
   void UpdateWriteBuffer(size_t platform_handles_written, size_t bytes_written);
 
   // Acquires read_lock_ and calls OnReadCompletedNoLock.
@@ -30,6 +30,9 @@ namespace edk {
 
 namespace {
 
+// Buffers are copied together for a single write up to this size.
+const size_t kMaxCoalescedWriteSize = 16 * 1024;
+
 struct MOJO_ALIGNAS(8) SerializedHandle {
   DWORD handle_pid;
   HANDLE handle;
@@ -674,12 +677,17 @@ class RawChannelWin final : public RawChannel {
     write_buffer_no_lock()->GetBuffers(&buffers);
     DCHECK(!buffers.empty());
 
-    // TODO(yzshen): Handle multi-segment writes more efficiently.
+    // Pipes don't support gathering writes, so small buffers (typically from
+    // several queued messages) are copied together to be written at once.
+    // Large ones are written one at a time, as the copy would cost more than
+    // the extra writes.
+    WriteBuffer::Buffer buffer = write_buffer_no_lock()->CoalesceBuffers(
+        buffers, kMaxCoalescedWriteSize);
     DWORD bytes_written_dword = 0;
 
     BOOL result =
-        WriteFile(io_handler_->handle(), buffers[0].addr,
-                  static_cast<DWORD>(buffers[0].size), &bytes_written_dword,
+        WriteFile(io_handler_->handle(), buffer.addr,
+                  static_cast<DWORD>(buffer.size), &bytes_written_dword,
                   &io_handler_->write_context_no_lock()->overlapped);
     if (!result) {
       DWORD error = GetLastError();
@@ -9,6 +9,15 @@
 namespace mojo {
 namespace internal {
 
+namespace {
+
+// Incoming message buffers larger than this are not kept around for reuse, so
+// that an occasional large message doesn't pin memory for the lifetime of the
+// pipe.
+const uint32_t kMaxReusableMessageBytes = 64 * 1024;
+
+}  // namespace
+
 // ----------------------------------------------------------------------------
 
 Connector::Connector(ScopedMessagePipeHandle message_pipe,
@@ -172,8 +181,15 @@ bool Connector::ReadSingleMessage(MojoResult* read_result) {
   bool* previous_destroyed_flag = destroyed_flag_;
   destroyed_flag_ = &was_destroyed_during_dispatch;
 
+  // Reads into a local message, so that |this| may be destroyed or re-entered
+  // during dispatch, but borrows the buffer of the previous message read from
+  // the pipe. When dispatch is re-entered, the nested reads allocate their
+  // own buffers.
+  Message message;
+  spare_message_.MoveTo(&message);
+
   MojoResult rv = ReadAndDispatchMessage(
-      message_pipe_.get(), incoming_receiver_, &receiver_result);
+      message_pipe_.get(), incoming_receiver_, &receiver_result, &message);
   if (read_result)
     *read_result = rv;
 
@@ -184,6 +200,13 @@ bool Connector::ReadSingleMessage(MojoResult* read_result) {
   }
   destroyed_flag_ = previous_destroyed_flag;
 
+  // The receiver may have taken the data out of the message, in which case
+  // there is nothing to give back.
+  if (message.data_capacity() <= kMaxReusableMessageBytes) {
+    message.ResetForReuse();
+    message.MoveTo(&spare_message_);
+  }
+
   if (rv == MOJO_RESULT_SHOULD_WAIT)
     return true;
 
@@ -128,6 +128,10 @@ class Connector : public MessageReceiver {
 
   bool paused_;
 
+  // Holds the data buffer of the last message read from the pipe, so that it
+  // can be reused for the next one.
+  Message spare_message_;
+
   // If non-null, this will be set to true when the Connector is destroyed.  We
   // use this flag to allow for the Connector to be destroyed as a side-effect
   // of dispatching an incoming message.
@@ -5,6 +5,7 @@
 #include "mojo/public/cpp/bindings/message.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include <algorithm>
 
@@ -28,15 +29,26 @@ void Message::Reset() {
 }
 
 void Message::AllocData(uint32_t num_bytes) {
-  MOJO_DCHECK(!data_);
-  data_num_bytes_ = num_bytes;
-  data_ = static_cast<internal::MessageData*>(calloc(num_bytes, 1));
+  MOJO_DCHECK(!data_num_bytes_);
+  if (!data_) {
+    data_num_bytes_ = num_bytes;
+    data_capacity_ = num_bytes;
+    data_ = static_cast<internal::MessageData*>(calloc(num_bytes, 1));
+    return;
+  }
+  EnsureCapacity(num_bytes);
+  memset(data_, 0, num_bytes);
 }
 
 void Message::AllocUninitializedData(uint32_t num_bytes) {
-  MOJO_DCHECK(!data_);
-  data_num_bytes_ = num_bytes;
-  data_ = static_cast<internal::MessageData*>(malloc(num_bytes));
+  MOJO_DCHECK(!data_num_bytes_);
+  EnsureCapacity(num_bytes);
+}
+
+void Message::ResetForReuse() {
+  CloseHandles();
+  handles_.clear();
+  data_num_bytes_ = 0;
 }
 
 void Message::MoveTo(Message* destination) {
@@ -46,6 +58,7 @@ void Message::MoveTo(Message* destination) {
 
   // No copy needed.
   destination->data_num_bytes_ = data_num_bytes_;
+  destination->data_capacity_ = data_capacity_;
   destination->data_ = data_;
   std::swap(destination->handles_, handles_);
 
@@ -55,12 +68,16 @@ void Message::MoveTo(Message* destination) {
 
 void Message::Initialize() {
   data_num_bytes_ = 0;
+  data_capacity_ = 0;
   data_ = nullptr;
 }
 
 void Message::FreeDataAndCloseHandles() {
   free(data_);
+  CloseHandles();
+}
 
+void Message::CloseHandles() {
   for (std::vector<Handle>::iterator it = handles_.begin();
        it != handles_.end(); ++it) {
     if (it->is_valid())
@@ -68,9 +85,27 @@ void Message::FreeDataAndCloseHandles() {
   }
 }
 
+void Message::EnsureCapacity(uint32_t num_bytes) {
+  if (!data_ || data_capacity_ < num_bytes) {
+    free(data_);
+    data_ = static_cast<internal::MessageData*>(malloc(num_bytes));
+    data_capacity_ = num_bytes;
+  }
+  data_num_bytes_ = num_bytes;
+}
+
 MojoResult ReadAndDispatchMessage(MessagePipeHandle handle,
                                   MessageReceiver* receiver,
                                   bool* receiver_result) {
+  Message message;
+  return ReadAndDispatchMessage(handle, receiver, receiver_result, &message);
+}
+
+MojoResult ReadAndDispatchMessage(MessagePipeHandle handle,
+                                  MessageReceiver* receiver,
+                                  bool* receiver_result,
+                                  Message* message) {
+  MOJO_DCHECK(!message->data_num_bytes() && message->handles()->empty());
   MojoResult rv;
 
   uint32_t num_bytes = 0, num_handles = 0;
@@ -83,21 +118,20 @@ MojoResult ReadAndDispatchMessage(MessagePipeHandle handle,
   if (rv != MOJO_RESULT_RESOURCE_EXHAUSTED)
     return rv;
 
-  Message message;
-  message.AllocUninitializedData(num_bytes);
-  message.mutable_handles()->resize(num_handles);
+  message->AllocUninitializedData(num_bytes);
+  message->mutable_handles()->resize(num_handles);
 
   rv = ReadMessageRaw(
       handle,
-      message.mutable_data(),
+      message->mutable_data(),
       &num_bytes,
-      message.mutable_handles()->empty()
+      message->mutable_handles()->empty()
           ? nullptr
-          : reinterpret_cast<MojoHandle*>(&message.mutable_handles()->front()),
+          : reinterpret_cast<MojoHandle*>(&message->mutable_handles()->front()),
       &num_handles,
       MOJO_READ_MESSAGE_FLAG_NONE);
   if (receiver && rv == MOJO_RESULT_OK)
-    *receiver_result = receiver->Accept(&message);
+    *receiver_result = receiver->Accept(message);
 
   return rv;
 }
@@ -23,9 +23,20 @@ class Message {
 
   void Reset();
 
+  // Allocates the message data. If the message still holds a buffer released
+  // by ResetForReuse() that is large enough, it is used instead of allocating
+  // a new one.
   void AllocData(uint32_t num_bytes);
   void AllocUninitializedData(uint32_t num_bytes);
 
+  // Like Reset(), but keeps the data buffer around so that a subsequent
+  // AllocData() or AllocUninitializedData() call can reuse it.
+  void ResetForReuse();
+
+  // The size of the data buffer, which may be larger than data_num_bytes() if
+  // the buffer was reused.
+  uint32_t data_capacity() const { return data_capacity_; }
+
   // Transfers data and handles to |destination|.
   void MoveTo(Message* destination);
 
@@ -75,8 +86,14 @@ class Message {
  private:
   void Initialize();
   void FreeDataAndCloseHandles();
+  void CloseHandles();
+
+  // Makes sure that |data_| can hold |num_bytes|, reusing the current buffer
+  // if possible.
+  void EnsureCapacity(uint32_t num_bytes);
 
   uint32_t data_num_bytes_;
+  uint32_t data_capacity_;
   internal::MessageData* data_;
   std::vector<Handle> handles_;
 
@@ -154,6 +171,13 @@ MojoResult ReadAndDispatchMessage(MessagePipeHandle handle,
                                   MessageReceiver* receiver,
                                   bool* receiver_result);
 
+// Same as above, but reads into |message|, which must be empty, so that the
+// caller can reuse its data buffer across reads. See Message::ResetForReuse().
+MojoResult ReadAndDispatchMessage(MessagePipeHandle handle,
+                                  MessageReceiver* receiver,
+                                  bool* receiver_result,
+                                  Message* message);
+
 }  // namespace mojo
 
 #endif  // MOJO_PUBLIC_CPP_BINDINGS_MESSAGE_H_
@@ -81,6 +81,12 @@ const unsigned kMaxCacheEntries = 256;
 // The number of seconds to cache entries.
 const unsigned kTTLSecs = 1800;  // 30 minutes.
 
+// Returns the sequence of |crl_set|, or 0 if there is no CRLSet. Cached
+// results are only valid for the CRLSet sequence they were verified with.
+uint32_t GetCRLSetSequence(const CRLSet* crl_set) {
+  return crl_set ? crl_set->sequence() : 0;
+}
+
 scoped_ptr<base::Value> CertVerifyResultCallback(
     const CertVerifyResult& verify_result,
     NetLogCaptureMode capture_mode) {
@@ -118,16 +124,20 @@ MultiThreadedCertVerifier::CachedResult::CachedResult() : error(ERR_FAILED) {}
 MultiThreadedCertVerifier::CachedResult::~CachedResult() {}
 
 MultiThreadedCertVerifier::CacheValidityPeriod::CacheValidityPeriod(
-    const base::Time& now)
+    const base::Time& now,
+    uint32_t crl_set_sequence)
     : verification_time(now),
-      expiration_time(now) {
+      expiration_time(now),
+      crl_set_sequence(crl_set_sequence) {
 }
 
 MultiThreadedCertVerifier::CacheValidityPeriod::CacheValidityPeriod(
     const base::Time& now,
-    const base::Time& expiration)
+    const base::Time& expiration,
+    uint32_t crl_set_sequence)
     : verification_time(now),
-      expiration_time(expiration) {
+      expiration_time(expiration),
+      crl_set_sequence(crl_set_sequence) {
 }
 
 bool MultiThreadedCertVerifier::CacheExpirationFunctor::operator()(
@@ -161,7 +171,11 @@ bool MultiThreadedCertVerifier::CacheExpirationFunctor::operator()(
   // because the cache has a fixed upper bound, if no entries are expired, a
   // 'random' entry will be, thus keeping the memory constraints bounded over
   // time.
-  return now.verification_time >= expiration.verification_time &&
+  //
+  // A result verified against a different CRLSet than the current one is
+  // treated as expired, since the newer CRLSet may revoke part of the chain.
+  return now.crl_set_sequence == expiration.crl_set_sequence &&
+         now.verification_time >= expiration.verification_time &&
          now.verification_time < expiration.expiration_time;
 };
 
@@ -254,8 +268,10 @@ class CertVerifierJob {
   CertVerifierJob(const MultiThreadedCertVerifier::RequestParams& key,
                   NetLog* net_log,
                   X509Certificate* cert,
+                  uint32_t crl_set_sequence,
                   MultiThreadedCertVerifier* cert_verifier)
       : key_(key),
+        crl_set_sequence_(crl_set_sequence),
         start_time_(base::TimeTicks::Now()),
         net_log_(BoundNetLog::Make(net_log, NetLog::SOURCE_CERT_VERIFIER_JOB)),
         cert_verifier_(cert_verifier),
@@ -361,7 +377,7 @@ class CertVerifierJob {
     scoped_ptr<CertVerifierJob> keep_alive = cert_verifier_->RemoveJob(this);
 
     LogMetrics(*verify_result);
-    cert_verifier_->SaveResultToCache(key_, *verify_result);
+    cert_verifier_->SaveResultToCache(key_, *verify_result, crl_set_sequence_);
     cert_verifier_ = nullptr;
 
     // TODO(eroman): If the cert_verifier_ is deleted from within one of the
@@ -375,6 +391,7 @@ class CertVerifierJob {
   }
 
   const MultiThreadedCertVerifier::RequestParams key_;
+  const uint32_t crl_set_sequence_;
   const base::TimeTicks start_time_;
 
   RequestList requests_;  // Non-owned.
@@ -433,8 +450,9 @@ int MultiThreadedCertVerifier::Verify(X509Certificate* cert,
 
   const RequestParams key(cert->fingerprint(), cert->ca_fingerprint(), hostname,
                           ocsp_response, flags, additional_trust_anchors);
-  const CertVerifierCache::value_type* cached_entry =
-      cache_.Get(key, CacheValidityPeriod(base::Time::Now()));
+  const uint32_t crl_set_sequence = GetCRLSetSequence(crl_set);
+  const CertVerifierCache::value_type* cached_entry = cache_.Get(
+      key, CacheValidityPeriod(base::Time::Now(), crl_set_sequence));
   if (cached_entry) {
     ++cache_hits_;
     *verify_result = cached_entry->result;
@@ -450,7 +468,8 @@ int MultiThreadedCertVerifier::Verify(X509Certificate* cert,
   } else {
     // Need to make a new job.
     scoped_ptr<CertVerifierJob> new_job(
-        new CertVerifierJob(key, net_log.net_log(), cert, this));
+        new CertVerifierJob(key, net_log.net_log(), cert, crl_set_sequence,
+                            this));
 
     if (!new_job->Start(verify_proc_, cert, hostname, ocsp_response, flags,
                         crl_set, additional_trust_anchors)) {
@@ -519,7 +538,8 @@ bool MultiThreadedCertVerifier::JobComparator::operator()(
 }
 
 void MultiThreadedCertVerifier::SaveResultToCache(const RequestParams& key,
-                                                  const CachedResult& result) {
+                                                  const CachedResult& result,
+                                                  uint32_t crl_set_sequence) {
   DCHECK(CalledOnValidThread());
 
   // When caching, this uses the time that validation started as the
@@ -545,11 +565,18 @@ void MultiThreadedCertVerifier::SaveResultToCache(const RequestParams& key,
   // was corrected after validation, if the cache validity period was
   // computed at the end of validation, it would continue to serve an
   // invalid result for kTTLSecs.
+  //
+  // The result is never cached beyond the point at which the verified leaf
+  // certificate itself expires, since it would fail verification from then on.
   const base::Time start_time = key.start_time;
-  cache_.Put(
-      key, result, CacheValidityPeriod(start_time),
-      CacheValidityPeriod(start_time,
-                          start_time + base::TimeDelta::FromSeconds(kTTLSecs)));
+  base::Time expiration_time =
+      start_time + base::TimeDelta::FromSeconds(kTTLSecs);
+  const X509Certificate* verified_cert = result.result.verified_cert.get();
+  if (verified_cert && !verified_cert->valid_expiry().is_null())
+    expiration_time = std::min(expiration_time, verified_cert->valid_expiry());
+  cache_.Put(key, result, CacheValidityPeriod(start_time, crl_set_sequence),
+             CacheValidityPeriod(start_time, expiration_time,
+                                 crl_set_sequence));
 }
 
 scoped_ptr<CertVerifierJob> MultiThreadedCertVerifier::RemoveJob(
@@ -119,13 +119,17 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
   // clock skew). CacheValidityPeriod and CacheExpirationFunctor are helpers to
   // ensure that expiration is measured both by the 'general' case (now + cache
   // TTL) and by whether or not significant enough clock skew was introduced
-  // since the last verification.
+  // since the last verification. A result is also only valid for as long as
+  // the CRLSet it was verified against is the current one.
   struct CacheValidityPeriod {
-    explicit CacheValidityPeriod(const base::Time& now);
-    CacheValidityPeriod(const base::Time& now, const base::Time& expiration);
+    CacheValidityPeriod(const base::Time& now, uint32_t crl_set_sequence);
+    CacheValidityPeriod(const base::Time& now,
+                        const base::Time& expiration,
+                        uint32_t crl_set_sequence);
 
     base::Time verification_time;
     base::Time expiration_time;
+    uint32_t crl_set_sequence;
   };
 
   struct CacheExpirationFunctor {
@@ -144,8 +148,11 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier
   typedef ExpiringCache<RequestParams, CachedResult, CacheValidityPeriod,
                         CacheExpirationFunctor> CertVerifierCache;
 
-  // Saves |result| into the cache, keyed by |key|.
-  void SaveResultToCache(const RequestParams& key, const CachedResult& result);
+  // Saves |result| into the cache, keyed by |key|. |crl_set_sequence| is the
+  // sequence of the CRLSet that was used for the verification.
+  void SaveResultToCache(const RequestParams& key,
+                         const CachedResult& result,
+                         uint32_t crl_set_sequence);
 
   // CertDatabase::Observer methods:
   void OnCACertChanged(const X509Certificate* cert) override;
@@ -5,7 +5,13 @@
 #include "net/disk_cache/memory/mem_backend_impl.h"
 
 #include "base/logging.h"
+#include "base/metrics/field_trial.h"
+#include "base/strings/stringprintf.h"
 #include "base/sys_info.h"
+#include "base/thread_task_runner_handle.h"
+#include "base/trace_event/memory_allocator_dump.h"
+#include "base/trace_event/memory_dump_manager.h"
+#include "base/trace_event/process_memory_dump.h"
 #include "net/base/net_errors.h"
 #include "net/disk_cache/cache_util.h"
 #include "net/disk_cache/memory/mem_entry_impl.h"
@@ -29,16 +35,31 @@ int LowWaterAdjust(int high_water) {
 namespace disk_cache {
 
 MemBackendImpl::MemBackendImpl(net::NetLog* net_log)
-    : max_size_(0), current_size_(0), net_log_(net_log), weak_factory_(this) {
+    : max_size_(0),
+      current_size_(0),
+      compression_enabled_(false),
+      compression_savings_(0),
+      net_log_(net_log),
+      weak_factory_(this) {
+  // The cache is not thread safe, so dumps have to be taken on this thread.
+  if (base::ThreadTaskRunnerHandle::IsSet()) {
+    base::trace_event::MemoryDumpManager::GetInstance()->RegisterDumpProvider(
+        this, "disk_cache::MemBackendImpl",
+        base::ThreadTaskRunnerHandle::Get());
+  }
 }
 
 MemBackendImpl::~MemBackendImpl() {
+  base::trace_event::MemoryDumpManager::GetInstance()->UnregisterDumpProvider(
+      this);
+
   EntryMap::iterator it = entries_.begin();
   while (it != entries_.end()) {
     it->second->Doom();
     it = entries_.begin();
   }
   DCHECK(!current_size_);
+  DCHECK(!compression_savings_);
 }
 
 // Static.
@@ -46,6 +67,9 @@ scoped_ptr<Backend> MemBackendImpl::CreateBackend(int max_bytes,
                                                   net::NetLog* net_log) {
   scoped_ptr<MemBackendImpl> cache(new MemBackendImpl(net_log));
   cache->SetMaxSize(max_bytes);
+  cache->set_compression_enabled(
+      base::FieldTrialList::FindFullName("InMemoryCacheCompression") ==
+      "Enabled");
   if (cache->Init())
     return cache.Pass();
 
@@ -114,6 +138,12 @@ void MemBackendImpl::ModifyStorageSize(int32 old_size, int32 new_size) {
     AddStorageSize(new_size - old_size);
 }
 
+void MemBackendImpl::ModifyCompressionSavings(int32 old_savings,
+                                              int32 new_savings) {
+  compression_savings_ += new_savings - old_savings;
+  DCHECK_GE(compression_savings_, 0);
+}
+
 int MemBackendImpl::MaxFileSize() const {
   return max_size_ / 8;
 }
@@ -230,6 +260,27 @@ void MemBackendImpl::OnExternalCacheHit(const std::string& key) {
   }
 }
 
+bool MemBackendImpl::OnMemoryDump(
+    const base::trace_event::MemoryDumpArgs& args,
+    base::trace_event::ProcessMemoryDump* pmd) {
+  std::string name = base::StringPrintf("net/http_cache/memory_backend/%p",
+                                        this);
+  base::trace_event::MemoryAllocatorDump* dump = pmd->CreateAllocatorDump(name);
+  dump->AddScalar(base::trace_event::MemoryAllocatorDump::kNameSize,
+                  base::trace_event::MemoryAllocatorDump::kUnitsBytes,
+                  current_size_);
+  dump->AddScalar(base::trace_event::MemoryAllocatorDump::kNameObjectCount,
+                  base::trace_event::MemoryAllocatorDump::kUnitsObjects,
+                  entries_.size());
+  dump->AddScalar("max_size",
+                  base::trace_event::MemoryAllocatorDump::kUnitsBytes,
+                  max_size_);
+  dump->AddScalar("compression_savings",
+                  base::trace_event::MemoryAllocatorDump::kUnitsBytes,
+                  compression_savings_);
+  return true;
+}
+
 bool MemBackendImpl::OpenEntry(const std::string& key, Entry** entry) {
   EntryMap::iterator it = entries_.find(key);
   if (it == entries_.end())
@@ -11,6 +11,7 @@
 #include "base/containers/hash_tables.h"
 #include "base/memory/weak_ptr.h"
 #include "base/strings/string_split.h"
+#include "base/trace_event/memory_dump_provider.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/memory/mem_rankings.h"
 
@@ -24,7 +25,9 @@ class MemEntryImpl;
 
 // This class implements the Backend interface. An object of this class handles
 // the operations of the cache without writing to disk.
-class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
+class NET_EXPORT_PRIVATE MemBackendImpl
+    : public Backend,
+      public base::trace_event::MemoryDumpProvider {
  public:
   explicit MemBackendImpl(net::NetLog* net_log);
   ~MemBackendImpl() override;
@@ -32,8 +35,9 @@ class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
   // Returns an instance of a Backend implemented only in memory. The returned
   // object should be deleted when not needed anymore. max_bytes is the maximum
   // size the cache can grow to. If zero is passed in as max_bytes, the cache
-  // will determine the value to use based on the available memory. The returned
-  // pointer can be NULL if a fatal error is found.
+  // will determine the value to use based on the available memory. Stream
+  // compression is enabled by the "InMemoryCacheCompression" field trial. The
+  // returned pointer can be NULL if a fatal error is found.
   static scoped_ptr<Backend> CreateBackend(int max_bytes, net::NetLog* net_log);
 
   // Performs general initialization for this current instance of the cache.
@@ -42,6 +46,13 @@ class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
   // Sets the maximum size for the total amount of data stored by this instance.
   bool SetMaxSize(int max_bytes);
 
+  // Enables transparent compression of the data of idle entries. Entries are
+  // compressed when they are closed and decompressed when they are next read
+  // or written, so this trades CPU on the cache thread for a higher hit ratio
+  // under a given |max_size_|.
+  void set_compression_enabled(bool enabled) { compression_enabled_ = enabled; }
+  bool compression_enabled() const { return compression_enabled_; }
+
   // Permanently deletes an entry.
   void InternalDoomEntry(MemEntryImpl* entry);
 
@@ -51,6 +62,10 @@ class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
   // A user data block is being created, extended or truncated.
   void ModifyStorageSize(int32 old_size, int32 new_size);
 
+  // The number of bytes saved by compressing a stream is changing. Only used
+  // for reporting; the storage itself is accounted by ModifyStorageSize().
+  void ModifyCompressionSavings(int32 old_savings, int32 new_savings);
+
   // Returns the maximum size for a file to reside on the cache.
   int MaxFileSize() const;
 
@@ -85,6 +100,10 @@ class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
   void GetStats(base::StringPairs* stats) override {}
   void OnExternalCacheHit(const std::string& key) override;
 
+  // base::trace_event::MemoryDumpProvider implementation.
+  bool OnMemoryDump(const base::trace_event::MemoryDumpArgs& args,
+                    base::trace_event::ProcessMemoryDump* pmd) override;
+
  private:
   class MemIterator;
   friend class MemIterator;
@@ -113,6 +132,8 @@ class NET_EXPORT_PRIVATE MemBackendImpl : public Backend {
   MemRankings rankings_;  // Rankings to be able to trim the cache.
   int32 max_size_;        // Maximum data size for this instance.
   int32 current_size_;
+  bool compression_enabled_;
+  int32 compression_savings_;  // Bytes saved by compressed streams.
 
   net::NetLog* net_log_;
 
@@ -12,6 +12,7 @@
 #include "net/base/net_errors.h"
 #include "net/disk_cache/memory/mem_backend_impl.h"
 #include "net/disk_cache/net_log_parameters.h"
+#include "third_party/zlib/zlib.h"
 
 using base::Time;
 
@@ -25,6 +26,23 @@ const int kMaxSparseEntryBits = 12;
 // Sparse entry has maximum size of 4KB.
 const int kMaxSparseEntrySize = 1 << kMaxSparseEntryBits;
 
+// Streams smaller than this are not worth compressing.
+const int kMinCompressibleSize = 1024;
+
+// Large streams are first tested by compressing this many bytes from their
+// start, so that data that is already compressed (most images, audio and
+// video) is rejected cheaply. The backend has no notion of MIME types.
+const int kCompressionSampleSize = 16 * 1024;
+
+// Favors speed: the cache thread is also the network thread.
+const int kCompressionLevel = 1;
+
+// Returns true if compressing |original_size| bytes into |compressed_size|
+// saves at least an eighth of the memory.
+bool CompressesWell(uLong original_size, uLong compressed_size) {
+  return compressed_size <= original_size - original_size / 8;
+}
+
 // Convert global offset to child index.
 inline int ToChildIndex(int64 offset) {
   return static_cast<int>(offset >> kMaxSparseEntryBits);
@@ -68,8 +86,11 @@ MemEntryImpl::MemEntryImpl(MemBackendImpl* backend) {
   child_first_pos_ = 0;
   next_ = NULL;
   prev_ = NULL;
-  for (int i = 0; i < NUM_STREAMS; i++)
+  for (int i = 0; i < NUM_STREAMS; i++) {
     data_size_[i] = 0;
+    compressed_[i] = false;
+    dirty_[i] = false;
+  }
 }
 
 // ------------------------------------------------------------------------
@@ -159,8 +180,12 @@ void MemEntryImpl::Close() {
   DCHECK(type() == kParentEntry);
   ref_count_--;
   DCHECK_GE(ref_count_, 0);
-  if (!ref_count_ && doomed_)
+  if (ref_count_)
+    return;
+  if (doomed_)
     InternalDoom();
+  else if (backend_->compression_enabled())
+    CompressStreams();
 }
 
 std::string MemEntryImpl::GetKey() const {
@@ -273,8 +298,11 @@ int MemEntryImpl::ReadyForSparseIO(const CompletionCallback& callback) {
 // ------------------------------------------------------------------------
 
 MemEntryImpl::~MemEntryImpl() {
-  for (int i = 0; i < NUM_STREAMS; i++)
-    backend_->ModifyStorageSize(data_size_[i], 0);
+  for (int i = 0; i < NUM_STREAMS; i++) {
+    if (compressed_[i])
+      backend_->ModifyCompressionSavings(data_size_[i] - StoredSize(i), 0);
+    backend_->ModifyStorageSize(StoredSize(i), 0);
+  }
   backend_->ModifyStorageSize(static_cast<int32>(key_.size()), 0);
   net_log_.EndEvent(net::NetLog::TYPE_DISK_CACHE_MEM_ENTRY_IMPL);
 }
@@ -296,6 +324,9 @@ int MemEntryImpl::InternalReadData(int index, int offset, IOBuffer* buf,
   if (offset + buf_len > entry_size)
     buf_len = entry_size - offset;
 
+  if (!EnsureDecompressed(index))
+    return net::ERR_FAILED;
+
   UpdateRank(false);
 
   memcpy(buf->data(), &(data_[index])[offset], buf_len);
@@ -320,6 +351,16 @@ int MemEntryImpl::InternalWriteData(int index, int offset, IOBuffer* buf,
     return net::ERR_FAILED;
   }
 
+  if (!EnsureDecompressed(index))
+    return net::ERR_FAILED;
+
+  // The deflated data is about to go stale.
+  if (!deflated_data_[index].empty()) {
+    backend_->ModifyStorageSize(StoredSize(index), data_size_[index]);
+    std::vector<char>().swap(deflated_data_[index]);
+  }
+  dirty_[index] = true;
+
   // Read the size at this point.
   int entry_size = GetDataSize(index);
 
@@ -528,6 +569,94 @@ void MemEntryImpl::PrepareTarget(int index, int offset, int buf_len) {
   memset(&(data_[index])[entry_size], 0, offset - entry_size);
 }
 
+void MemEntryImpl::CompressStreams() {
+  DCHECK(type() == kParentEntry);
+  for (int i = 1; i < NUM_STREAMS; i++)
+    CompressStream(i);
+}
+
+void MemEntryImpl::CompressStream(int index) {
+  if (compressed_[index])
+    return;
+
+  if (!dirty_[index]) {
+    // The stream was only read since it was last compressed, or it was found
+    // not to be worth compressing.
+    if (!deflated_data_[index].empty()) {
+      int32 stored_size = StoredSize(index);
+      data_[index].swap(deflated_data_[index]);
+      std::vector<char>().swap(deflated_data_[index]);
+      compressed_[index] = true;
+      backend_->ModifyCompressionSavings(
+          0, data_size_[index] - StoredSize(index));
+      backend_->ModifyStorageSize(stored_size, StoredSize(index));
+    }
+    return;
+  }
+  dirty_[index] = false;
+
+  int32 size = data_size_[index];
+  if (size < kMinCompressibleSize)
+    return;
+
+  const Bytef* source = reinterpret_cast<const Bytef*>(&(data_[index])[0]);
+  if (size > 2 * kCompressionSampleSize) {
+    std::vector<char> sample(compressBound(kCompressionSampleSize));
+    uLongf sample_size = sample.size();
+    if (compress2(reinterpret_cast<Bytef*>(&sample[0]), &sample_size, source,
+                  kCompressionSampleSize, kCompressionLevel) != Z_OK ||
+        !CompressesWell(kCompressionSampleSize, sample_size)) {
+      return;
+    }
+  }
+
+  std::vector<char> compressed(compressBound(size));
+  uLongf compressed_size = compressed.size();
+  if (compress2(reinterpret_cast<Bytef*>(&compressed[0]), &compressed_size,
+                source, size, kCompressionLevel) != Z_OK ||
+      !CompressesWell(size, compressed_size)) {
+    return;
+  }
+
+  // Copies rather than resizes, so that the slack of both the original and
+  // the scratch buffers is released.
+  std::vector<char>(compressed.begin(), compressed.begin() + compressed_size)
+      .swap(data_[index]);
+  compressed_[index] = true;
+  backend_->ModifyCompressionSavings(0, size - StoredSize(index));
+  backend_->ModifyStorageSize(size, StoredSize(index));
+}
+
+bool MemEntryImpl::EnsureDecompressed(int index) {
+  if (!compressed_[index])
+    return true;
+
+  int32 stored_size = StoredSize(index);
+  std::vector<char> data(data_size_[index]);
+  uLongf size = data.size();
+  if (uncompress(reinterpret_cast<Bytef*>(&data[0]), &size,
+                 reinterpret_cast<const Bytef*>(&(data_[index])[0]),
+                 stored_size) != Z_OK ||
+      size != data.size()) {
+    LOG(ERROR) << "Unable to inflate a cache stream";
+    return false;
+  }
+
+  deflated_data_[index].swap(data_[index]);
+  data_[index].swap(data);
+  compressed_[index] = false;
+  backend_->ModifyCompressionSavings(data_size_[index] - stored_size, 0);
+  // This may trim the cache, but entries in use are never evicted.
+  backend_->ModifyStorageSize(stored_size, StoredSize(index));
+  return true;
+}
+
+int32 MemEntryImpl::StoredSize(int index) const {
+  if (compressed_[index])
+    return static_cast<int32>(data_[index].size());
+  return data_size_[index] + static_cast<int32>(deflated_data_[index].size());
+}
+
 void MemEntryImpl::UpdateRank(bool modified) {
   Time current = Time::Now();
   last_used_ = current;
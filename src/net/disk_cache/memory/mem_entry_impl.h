@@ -142,6 +142,24 @@ class MemEntryImpl : public Entry {
   // Grows and cleans up the data buffer.
   void PrepareTarget(int index, int offset, int buf_len);
 
+  // Compresses the data streams of this entry once it is no longer in use.
+  // The headers stream is left alone, as it is read whenever the entry is
+  // opened.
+  void CompressStreams();
+
+  // Compresses stream |index| in place, if it was written since it was last
+  // compressed, is large enough and compresses well. A stream that was only
+  // read gets its previous deflated data back instead.
+  void CompressStream(int index);
+
+  // Restores the plain data of stream |index| before it is accessed, keeping
+  // the deflated data until the stream is written or compressed again.
+  // Returns false if the stored data could not be inflated.
+  bool EnsureDecompressed(int index);
+
+  // Returns the number of bytes accounted to the backend for stream |index|.
+  int32 StoredSize(int index) const;
+
   // Updates ranking information.
   void UpdateRank(bool modified);
 
@@ -171,6 +189,10 @@ class MemEntryImpl : public Entry {
   std::string key_;
   std::vector<char> data_[NUM_STREAMS];  // User data.
   int32 data_size_[NUM_STREAMS];
+  bool compressed_[NUM_STREAMS];  // True if |data_| holds deflated data.
+  // The deflated data of streams that were inflated to be read.
+  std::vector<char> deflated_data_[NUM_STREAMS];
+  bool dirty_[NUM_STREAMS];  // True if written since last compressed.
   int ref_count_;
 
   int child_id_;              // The ID of a child entry.
@@ -49,11 +49,27 @@
 
 namespace {
 
+// Size of the buffer used to read the body of a revalidated response.
+const int kAsyncValidationBufferSize = 32 * 1024;
+
 bool UseCertCache() {
   return base::FieldTrialList::FindFullName("CertCacheTrial") ==
          "ExperimentGroup";
 }
 
+// Whether stale-while-revalidate entries are served while they are
+// revalidated in the background.
+bool UseStaleWhileRevalidate() {
+  return base::FieldTrialList::FindFullName("StaleWhileRevalidate") ==
+         "Enabled";
+}
+
+// Whether transactions may read a response body while it is being written.
+bool UseStreamingReaders() {
+  return base::FieldTrialList::FindFullName("HttpCacheStreamingReaders") ==
+         "Enabled";
+}
+
 }  // namespace
 
 namespace net {
@@ -102,7 +118,10 @@ HttpCache::ActiveEntry::ActiveEntry(disk_cache::Entry* entry)
     : disk_entry(entry),
       writer(NULL),
       will_process_pending_queue(false),
-      doomed(false) {
+      doomed(false),
+      streaming(false),
+      streamed_size(0),
+      streamed_complete(false) {
 }
 
 HttpCache::ActiveEntry::~ActiveEntry() {
@@ -281,6 +300,129 @@ void HttpCache::MetadataWriter::OnIOComplete(int result) {
 
 //-----------------------------------------------------------------------------
 
+// This class encapsulates a transaction that revalidates an entry that was
+// served stale because of "Cache-Control: stale-while-revalidate". If the
+// server sends a new response, it is read to completion so that the entry is
+// fully updated. The cache owns the object and deletes it when it is done.
+//
+// The request is sent without a URLRequest or NetworkDelegate, so it is only
+// used for requests without cookies or credentials. Set-Cookie headers in the
+// response are not stored. Auth challenges and client certificate requests
+// end the revalidation and leave the entry to the next regular validation.
+class HttpCache::AsyncValidation {
+ public:
+  AsyncValidation(const HttpRequestInfo& original_request,
+                  const std::string& key,
+                  HttpCache* cache);
+  ~AsyncValidation();
+
+  void Start();
+
+ private:
+  void OnStarted(int result);
+  void DoRead();
+  void OnRead(int result);
+
+  // Reports the outcome and has the cache delete this object. Nothing may be
+  // done after calling this method.
+  void Terminate(int result);
+
+  HttpRequestInfo request_;
+  const std::string key_;
+  HttpCache* const cache_;
+  scoped_ptr<Transaction> transaction_;
+  scoped_refptr<IOBuffer> buf_;
+  CompletionCallback read_callback_;
+  base::TimeTicks start_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncValidation);
+};
+
+HttpCache::AsyncValidation::AsyncValidation(
+    const HttpRequestInfo& original_request,
+    const std::string& key,
+    HttpCache* cache)
+    : request_(original_request), key_(key), cache_(cache) {
+  // Only keep the flags that affect how the request is sent, and make sure
+  // that the entry is validated.
+  const int kInheritedLoadFlags =
+      LOAD_DISABLE_CERT_REVOCATION_CHECKING | LOAD_DO_NOT_SAVE_COOKIES |
+      LOAD_BYPASS_PROXY | LOAD_VERIFY_EV_CERT | LOAD_DO_NOT_SEND_COOKIES |
+      LOAD_DO_NOT_SEND_AUTH_DATA | LOAD_DO_NOT_USE_EMBEDDED_IDENTITY;
+  request_.load_flags =
+      (request_.load_flags & kInheritedLoadFlags) | LOAD_VALIDATE_CACHE;
+}
+
+HttpCache::AsyncValidation::~AsyncValidation() {}
+
+void HttpCache::AsyncValidation::Start() {
+  start_time_ = base::TimeTicks::Now();
+  transaction_.reset(new Transaction(IDLE, cache_));
+  int rv = transaction_->Start(
+      &request_,
+      base::Bind(&AsyncValidation::OnStarted, base::Unretained(this)),
+      BoundNetLog());
+  if (rv != ERR_IO_PENDING)
+    OnStarted(rv);
+}
+
+void HttpCache::AsyncValidation::OnStarted(int result) {
+  if (result != OK) {
+    Terminate(result);
+    return;
+  }
+
+  // There is nobody to answer an auth challenge. The entry is left as it is,
+  // and the next regular validation will deal with it.
+  const HttpResponseInfo* response = transaction_->GetResponseInfo();
+  int response_code = response->headers.get()
+                          ? response->headers->response_code()
+                          : 0;
+  if (response_code == 401 || response_code == 407) {
+    Terminate(ERR_ACCESS_DENIED);
+    return;
+  }
+
+  // The entry was still valid and its headers are now updated.
+  if (response->was_cached) {
+    Terminate(OK);
+    return;
+  }
+
+  buf_ = new IOBuffer(kAsyncValidationBufferSize);
+  read_callback_ =
+      base::Bind(&AsyncValidation::OnRead, base::Unretained(this));
+  DoRead();
+}
+
+void HttpCache::AsyncValidation::DoRead() {
+  int rv;
+  do {
+    rv = transaction_->Read(buf_.get(), kAsyncValidationBufferSize,
+                            read_callback_);
+  } while (rv > 0);
+
+  if (rv != ERR_IO_PENDING)
+    Terminate(rv);
+}
+
+void HttpCache::AsyncValidation::OnRead(int result) {
+  if (result > 0) {
+    DoRead();
+    return;
+  }
+  Terminate(result);
+}
+
+void HttpCache::AsyncValidation::Terminate(int result) {
+  UMA_HISTOGRAM_TIMES("HttpCache.AsyncValidation.Duration",
+                      base::TimeTicks::Now() - start_time_);
+  cache_->DeleteAsyncValidation(key_);
+  // |this| is deleted.
+}
+
+//-----------------------------------------------------------------------------
+
 class HttpCache::QuicServerInfoFactoryAdaptor : public QuicServerInfoFactory {
  public:
   explicit QuicServerInfoFactoryAdaptor(HttpCache* http_cache)
@@ -311,6 +453,8 @@ HttpCache::HttpCache(scoped_ptr<HttpTransactionFactory> network_layer,
       building_backend_(false),
       bypass_lock_for_test_(false),
       fail_conditionalization_for_test_(false),
+      use_stale_while_revalidate_(UseStaleWhileRevalidate()),
+      use_streaming_readers_(UseStreamingReaders()),
       mode_(NORMAL),
       network_layer_(network_layer.Pass()),
       clock_(new base::DefaultClock()),
@@ -335,6 +479,9 @@ HttpCache::~HttpCache() {
   // could see an inconsistent object (half destroyed).
   weak_factory_.InvalidateWeakPtrs();
 
+  // Background revalidations can't reach the cache anymore.
+  STLDeleteValues(&async_validations_);
+
   // If we have any active entries remaining, then we need to deactivate them.
   // We may have some pending calls to OnProcessPendingQueue, but since those
   // won't run (due to our destruction), we can simply ignore the corresponding
@@ -344,6 +491,7 @@ HttpCache::~HttpCache() {
     entry->will_process_pending_queue = false;
     entry->pending_queue.clear();
     entry->readers.clear();
+    entry->streaming_readers.clear();
     entry->writer = NULL;
     DeactivateEntry(entry);
   }
@@ -802,6 +950,16 @@ int HttpCache::AddTransactionToEntry(ActiveEntry* entry, Transaction* trans) {
   //
   // NOTE: If the transaction can only write, then the entry should not be in
   // use (since any existing entry should have already been doomed).
+  //
+  // The exception to this is a writer that is streaming a response body:
+  // transactions that only need to read it join as streaming readers.
+
+  if (entry->streaming && trans->CanStreamFromWriter()) {
+    entry->streaming_readers.push_back(trans);
+    if (!entry->pending_queue.empty())
+      ProcessPendingQueue(entry);
+    return OK;
+  }
 
   if (entry->writer || entry->will_process_pending_queue) {
     entry->pending_queue.push_back(trans);
@@ -834,12 +992,12 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
                               bool cancel) {
   // If we already posted a task to move on to the next transaction and this was
   // the writer, there is nothing to cancel.
-  if (entry->will_process_pending_queue && entry->readers.empty())
+  if (entry->will_process_pending_queue && !entry->writer &&
+      entry->readers.empty()) {
     return;
+  }
 
-  if (entry->writer) {
-    DCHECK(trans == entry->writer);
-
+  if (entry->writer == trans) {
     // Assume there was a failure.
     bool success = false;
     if (cancel) {
@@ -860,19 +1018,27 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
 void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
   DCHECK(entry->readers.empty());
 
+  DoneStreamingToEntry(entry, false);
   entry->writer = NULL;
 
+  // Streaming readers carry on with what was written, as regular readers.
+  entry->readers.swap(entry->streaming_readers);
+
   if (success) {
     ProcessPendingQueue(entry);
   } else {
-    DCHECK(!entry->will_process_pending_queue);
-
     // We failed to create this entry.
     TransactionList pending_queue;
     pending_queue.swap(entry->pending_queue);
 
-    entry->disk_entry->Doom();
-    DestroyEntry(entry);
+    if (entry->readers.empty() && !entry->will_process_pending_queue) {
+      entry->disk_entry->Doom();
+      DestroyEntry(entry);
+    } else if (!entry->doomed) {
+      // The entry is still used by streaming readers, so it is destroyed once
+      // they are done with it.
+      DoomActiveEntry(entry->disk_entry->GetKey());
+    }
 
     // We need to do something about these pending entries, which now need to
     // be added to a new entry.
@@ -885,7 +1051,15 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
 }
 
 void HttpCache::DoneReadingFromEntry(ActiveEntry* entry, Transaction* trans) {
-  DCHECK(!entry->writer);
+  if (entry->writer) {
+    // |trans| was streaming the body from the writer.
+    TransactionList::iterator it = std::find(entry->streaming_readers.begin(),
+                                             entry->streaming_readers.end(),
+                                             trans);
+    DCHECK(it != entry->streaming_readers.end());
+    entry->streaming_readers.erase(it);
+    return;
+  }
 
   TransactionList::iterator it =
       std::find(entry->readers.begin(), entry->readers.end(), trans);
@@ -900,6 +1074,7 @@ void HttpCache::ConvertWriterToReader(ActiveEntry* entry) {
   DCHECK(entry->writer);
   DCHECK(entry->writer->mode() == Transaction::READ_WRITE);
   DCHECK(entry->readers.empty());
+  DCHECK(entry->streaming_readers.empty());
 
   Transaction* trans = entry->writer;
 
@@ -909,6 +1084,65 @@ void HttpCache::ConvertWriterToReader(ActiveEntry* entry) {
   ProcessPendingQueue(entry);
 }
 
+void HttpCache::StartStreamingToReaders(ActiveEntry* entry) {
+  DCHECK(entry->writer);
+  DCHECK(entry->readers.empty());
+  if (!use_streaming_readers_)
+    return;
+
+  entry->streaming = true;
+  entry->streamed_size = 0;
+  entry->streamed_complete = false;
+
+  // Let in the transactions that were waiting for the headers to be written.
+  if (!entry->pending_queue.empty())
+    ProcessPendingQueue(entry);
+}
+
+void HttpCache::OnStreamedDataWritten(ActiveEntry* entry, int size) {
+  if (!entry->streaming)
+    return;
+
+  DCHECK_GE(size, entry->streamed_size);
+  entry->streamed_size = size;
+  NotifyStreamingReaders(entry);
+}
+
+void HttpCache::DoneStreamingToEntry(ActiveEntry* entry, bool complete) {
+  if (!entry->streaming)
+    return;
+
+  entry->streaming = false;
+  entry->streamed_complete = complete;
+  NotifyStreamingReaders(entry);
+}
+
+void HttpCache::NotifyStreamingReaders(ActiveEntry* entry) {
+  for (TransactionList::iterator it = entry->streaming_readers.begin();
+       it != entry->streaming_readers.end(); ++it) {
+    (*it)->OnStreamedDataAvailable();
+  }
+}
+
+void HttpCache::PerformAsyncValidation(const HttpRequestInfo& original_request,
+                                       const std::string& key) {
+  if (async_validations_.count(key))
+    return;
+
+  AsyncValidation* validation =
+      new AsyncValidation(original_request, key, this);
+  async_validations_[key] = validation;
+  // This may complete (and delete |validation|) synchronously.
+  validation->Start();
+}
+
+void HttpCache::DeleteAsyncValidation(const std::string& key) {
+  AsyncValidationMap::iterator it = async_validations_.find(key);
+  DCHECK(it != async_validations_.end());
+  delete it->second;
+  async_validations_.erase(it);
+}
+
 LoadState HttpCache::GetLoadStateForPendingTransaction(
       const Transaction* trans) {
   ActiveEntriesMap::const_iterator i = active_entries_.find(trans->key());
@@ -1002,7 +1236,29 @@ void HttpCache::ProcessPendingQueue(ActiveEntry* entry) {
 
 void HttpCache::OnProcessPendingQueue(ActiveEntry* entry) {
   entry->will_process_pending_queue = false;
-  DCHECK(!entry->writer);
+
+  if (entry->writer) {
+    // The writer is streaming the body, so only transactions that can read it
+    // while it is being written are let in; the rest wait for the writer.
+    if (!entry->streaming)
+      return;
+
+    TransactionList::iterator it = entry->pending_queue.begin();
+    for (; it != entry->pending_queue.end(); ++it) {
+      if ((*it)->CanStreamFromWriter())
+        break;
+    }
+    if (it == entry->pending_queue.end())
+      return;
+
+    Transaction* next = *it;
+    entry->pending_queue.erase(it);
+
+    int rv = AddTransactionToEntry(entry, next);
+    DCHECK_EQ(OK, rv);
+    next->io_callback().Run(rv);
+    return;
+  }
 
   // If no one is interested in this entry, then we can deactivate it.
   if (entry->pending_queue.empty()) {
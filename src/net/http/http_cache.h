@@ -182,6 +182,24 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   void set_mode(Mode value) { mode_ = value; }
   Mode mode() { return mode_; }
 
+  // Get/Set whether entries that may be used stale under
+  // "Cache-Control: stale-while-revalidate" are served without waiting for
+  // the network, while the cache revalidates them in the background. The
+  // default is set by the "StaleWhileRevalidate" field trial.
+  void set_use_stale_while_revalidate(bool value) {
+    use_stale_while_revalidate_ = value;
+  }
+  bool use_stale_while_revalidate() const {
+    return use_stale_while_revalidate_;
+  }
+
+  // Get/Set whether transactions that only need to read an entry may read
+  // its body while another transaction is still writing it, instead of
+  // waiting for the writer to finish. The default is set by the
+  // "HttpCacheStreamingReaders" field trial.
+  void set_use_streaming_readers(bool value) { use_streaming_readers_ = value; }
+  bool use_streaming_readers() const { return use_streaming_readers_; }
+
   // Get/Set the cache's clock. These are public only for testing.
   void SetClockForTesting(scoped_ptr<base::Clock> clock) {
     clock_.reset(clock.release());
@@ -241,6 +259,7 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
     kNumCacheEntryDataIndices
   };
 
+  class AsyncValidation;
   class MetadataWriter;
   class QuicServerInfoFactoryAdaptor;
   class Transaction;
@@ -262,12 +281,23 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
     TransactionList    pending_queue;
     bool               will_process_pending_queue;
     bool               doomed;
+
+    // Readers admitted while |writer| is still storing the response body.
+    // They become regular |readers| once the writer is done.
+    TransactionList    streaming_readers;
+    // True while |writer| is appending the body of a complete response that
+    // |streaming_readers| may read up to |streamed_size| bytes of.
+    bool               streaming;
+    int                streamed_size;
+    // Whether the writer stored the whole body before it stopped streaming.
+    bool               streamed_complete;
   };
 
   typedef base::hash_map<std::string, ActiveEntry*> ActiveEntriesMap;
   typedef base::hash_map<std::string, PendingOp*> PendingOpsMap;
   typedef std::set<ActiveEntry*> ActiveEntriesSet;
   typedef base::hash_map<std::string, int> PlaybackCacheMap;
+  typedef base::hash_map<std::string, AsyncValidation*> AsyncValidationMap;
 
   // Methods ------------------------------------------------------------------
 
@@ -364,6 +394,34 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // transactions can start reading from this entry.
   void ConvertWriterToReader(ActiveEntry* entry);
 
+  // Called by the writer of |entry| once the response headers are stored and
+  // only the body remains to be written. Transactions that can use the entry
+  // without validating it are then let in to read the body as it is written,
+  // instead of waiting for the whole response.
+  void StartStreamingToReaders(ActiveEntry* entry);
+
+  // Called by the writer of |entry| when the first |size| bytes of the body
+  // are stored.
+  void OnStreamedDataWritten(ActiveEntry* entry, int size);
+
+  // Called when the writer of |entry| stops appending to the body. |complete|
+  // is true if the whole body was stored; otherwise streaming readers fetch
+  // the rest from the network once they have read what is there.
+  void DoneStreamingToEntry(ActiveEntry* entry, bool complete);
+
+  // Lets the streaming readers of |entry| that caught up with the writer know
+  // that the state of the body changed.
+  void NotifyStreamingReaders(ActiveEntry* entry);
+
+  // Revalidates the entry for |key| in the background, using a copy of
+  // |original_request|. Does nothing if the entry is already being
+  // revalidated this way.
+  void PerformAsyncValidation(const HttpRequestInfo& original_request,
+                              const std::string& key);
+
+  // Deletes the finished AsyncValidation for |key|.
+  void DeleteAsyncValidation(const std::string& key);
+
   // Returns the LoadState of the provided pending transaction.
   LoadState GetLoadStateForPendingTransaction(const Transaction* trans);
 
@@ -412,6 +470,8 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   bool building_backend_;
   bool bypass_lock_for_test_;
   bool fail_conditionalization_for_test_;
+  bool use_stale_while_revalidate_;
+  bool use_streaming_readers_;
 
   Mode mode_;
 
@@ -432,6 +492,9 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
 
   scoped_ptr<PlaybackCacheMap> playback_cache_map_;
 
+  // The background revalidations in progress, indexed by cache key.
+  AsyncValidationMap async_validations_;
+
   // A clock that can be swapped out for testing.
   scoped_ptr<base::Clock> clock_;
 
@@ -267,6 +267,9 @@ HttpCache::Transaction::Transaction(RequestPriority priority, HttpCache* cache)
       couldnt_conditionalize_request_(false),
       bypass_lock_for_test_(false),
       fail_conditionalization_for_test_(false),
+      streaming_from_writer_(false),
+      waiting_for_streamed_data_(false),
+      wait_for_writer_(false),
       io_buf_len_(0),
       read_offset_(0),
       effective_load_flags_(0),
@@ -334,8 +337,11 @@ bool HttpCache::Transaction::AddTruncatedFlag() {
     return false;
 
   // We may have received the whole resource already.
-  if (done_reading_)
+  if (done_reading_) {
+    if (entry_)
+      cache_->DoneStreamingToEntry(entry_, true);
     return true;
+  }
 
   truncated_ = true;
   next_state_ = STATE_CACHE_WRITE_TRUNCATED_RESPONSE;
@@ -351,6 +357,23 @@ LoadState HttpCache::Transaction::GetWriterLoadState() const {
   return LOAD_STATE_WAITING_FOR_CACHE;
 }
 
+bool HttpCache::Transaction::CanStreamFromWriter() const {
+  return (mode_ == READ || mode_ == READ_WRITE) && !partial_ &&
+         request_->method == "GET" &&
+         !(effective_load_flags_ & LOAD_PREFETCH) && !wait_for_writer_;
+}
+
+void HttpCache::Transaction::OnStreamedDataAvailable() {
+  if (!waiting_for_streamed_data_)
+    return;
+
+  // This is called while the writer is busy with the entry, so resume later.
+  waiting_for_streamed_data_ = false;
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE, base::Bind(&Transaction::OnIOComplete,
+                            weak_factory_.GetWeakPtr(), OK));
+}
+
 const BoundNetLog& HttpCache::Transaction::net_log() const {
   return net_log_;
 }
@@ -508,6 +531,8 @@ void HttpCache::Transaction::StopCaching() {
   //                Fix this.
   if (cache_.get() && entry_ && (mode_ & WRITE) && network_trans_.get() &&
       !is_sparse_ && !range_requested_) {
+    // Nothing else will be stored, so readers can't wait for the body.
+    cache_->DoneStreamingToEntry(entry_, false);
     mode_ = NONE;
   }
 }
@@ -539,6 +564,7 @@ void HttpCache::Transaction::DoneReading() {
   if (cache_.get() && entry_) {
     DCHECK_NE(mode_, UPDATE);
     if (mode_ & WRITE) {
+      cache_->DoneStreamingToEntry(entry_, true);
       DoneWritingToEntry(true);
     } else if (mode_ & READ) {
       // It is necessary to check mode_ & READ because it is possible
@@ -558,6 +584,10 @@ const HttpResponseInfo* HttpCache::Transaction::GetResponseInfo() const {
 }
 
 LoadState HttpCache::Transaction::GetLoadState() const {
+  // A streaming reader that caught up waits on the writer's network activity.
+  if (waiting_for_streamed_data_ && cache_.get() && entry_->writer)
+    return entry_->writer->GetWriterLoadState();
+
   LoadState state = GetWriterLoadState();
   if (state != LOAD_STATE_WAITING_FOR_CACHE)
     return state;
@@ -935,6 +965,13 @@ int HttpCache::Transaction::DoLoop(int result) {
       case STATE_CACHE_READ_DATA_COMPLETE:
         rv = DoCacheReadDataComplete(rv);
         break;
+      case STATE_RESUME_STREAMED_BODY:
+        DCHECK_EQ(OK, rv);
+        rv = DoResumeStreamedBody();
+        break;
+      case STATE_RESUME_STREAMED_BODY_COMPLETE:
+        rv = DoResumeStreamedBodyComplete(rv);
+        break;
       case STATE_CACHE_WRITE_DATA:
         rv = DoCacheWriteData(rv);
         break;
@@ -1208,8 +1245,11 @@ int HttpCache::Transaction::DoAddToEntryComplete(int result) {
   DCHECK(new_entry_);
   cache_pending_ = false;
 
-  if (result == OK)
+  if (result == OK) {
     entry_ = new_entry_;
+    // Only streaming readers are let in while another transaction writes.
+    streaming_from_writer_ = entry_->writer && entry_->writer != this;
+  }
 
   // If there is a failure, the cache should have taken care of new_entry_.
   new_entry_ = NULL;
@@ -1722,6 +1762,17 @@ int HttpCache::Transaction::DoTruncateCachedMetadataComplete(int result) {
       net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HTTP_CACHE_WRITE_INFO,
                                         result);
     }
+
+    // The headers of a new, complete response are stored and the body comes
+    // next: other transactions may read it as it is written.
+    // Strong validators let readers fetch the rest of the body with a range
+    // request if this transaction stops before storing all of it.
+    if (mode_ == WRITE && !partial_ && request_->method == "GET" &&
+        response_.headers->response_code() == 200 &&
+        response_.headers->HasStrongValidators() &&
+        !(effective_load_flags_ & LOAD_PREFETCH)) {
+      cache_->StartStreamingToReaders(entry_);
+    }
   }
 
   next_state_ = STATE_PARTIAL_HEADERS_RECEIVED;
@@ -1797,6 +1848,31 @@ int HttpCache::Transaction::DoCacheReadData() {
     return 0;
 
   DCHECK(entry_);
+
+  if (streaming_from_writer_) {
+    // We may be resuming after the writer made progress.
+    if (!cache_.get())
+      return ERR_UNEXPECTED;
+
+    int available = entry_->streamed_size - read_offset_;
+    if (available <= 0) {
+      if (entry_->streaming) {
+        // Wait for the writer to store more data.
+        waiting_for_streamed_data_ = true;
+        next_state_ = STATE_CACHE_READ_DATA;
+        return ERR_IO_PENDING;
+      }
+      // The writer stopped before storing the whole body, e.g. because it was
+      // canceled. Fetch the rest of it from the network.
+      if (!entry_->streamed_complete) {
+        next_state_ = STATE_RESUME_STREAMED_BODY;
+        return OK;
+      }
+    } else {
+      io_buf_len_ = std::min(io_buf_len_, available);
+    }
+  }
+
   next_state_ = STATE_CACHE_READ_DATA_COMPLETE;
 
   if (net_log_.IsCapturing())
@@ -1839,6 +1915,87 @@ int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
   return result;
 }
 
+bool HttpCache::Transaction::RequestHasCredentials() const {
+  return request_->url.has_username() ||
+         request_->extra_headers.HasHeader(HttpRequestHeaders::kCookie) ||
+         request_->extra_headers.HasHeader(
+             HttpRequestHeaders::kAuthorization) ||
+         request_->extra_headers.HasHeader(
+             HttpRequestHeaders::kProxyAuthorization);
+}
+
+// A streaming reader whose writer stopped early requests the part of the body
+// that it didn't read from the cache, and reads it straight from the network.
+int HttpCache::Transaction::DoResumeStreamedBody() {
+  DCHECK(streaming_from_writer_);
+
+  if (effective_load_flags_ & LOAD_ONLY_FROM_CACHE)
+    return ERR_CACHE_READ_FAILURE;
+
+  // Only strong validators can be used with If-Range, and the writer only
+  // streams responses that have one.
+  std::string validator;
+  response_.headers->EnumerateHeader(NULL, "etag", &validator);
+  if (validator.empty() ||
+      base::StartsWith(validator, "W/", base::CompareCase::SENSITIVE)) {
+    validator.clear();
+    response_.headers->EnumerateHeader(NULL, "last-modified", &validator);
+  }
+  if (validator.empty())
+    return ERR_CACHE_READ_FAILURE;
+
+  cache_->DoneReadingFromEntry(entry_, this);
+  entry_ = NULL;
+  streaming_from_writer_ = false;
+  mode_ = NONE;
+
+  if (!custom_request_.get()) {
+    custom_request_.reset(new HttpRequestInfo(*request_));
+    request_ = custom_request_.get();
+  }
+  custom_request_->extra_headers.SetHeader(
+      HttpRequestHeaders::kRange,
+      base::StringPrintf("bytes=%d-", read_offset_));
+  custom_request_->extra_headers.SetHeader(HttpRequestHeaders::kIfRange,
+                                           validator);
+
+  int rv =
+      cache_->network_layer_->CreateTransaction(priority_, &network_trans_);
+  if (rv != OK)
+    return rv;
+
+  next_state_ = STATE_RESUME_STREAMED_BODY_COMPLETE;
+  return network_trans_->Start(request_, io_callback_, net_log_);
+}
+
+int HttpCache::Transaction::DoResumeStreamedBodyComplete(int result) {
+  if (!cache_.get())
+    return ERR_UNEXPECTED;
+
+  if (result != OK) {
+    ResetNetworkTransaction();
+    return result;
+  }
+
+  // Anything but the exact remainder of the same resource, e.g. because it
+  // changed or the server ignored the range, can't complete the body.
+  const HttpResponseHeaders* headers =
+      network_trans_->GetResponseInfo()->headers.get();
+  int64 first_byte_position = -1;
+  int64 last_byte_position = -1;
+  int64 instance_length = -1;
+  if (headers->response_code() != 206 ||
+      !headers->GetContentRange(&first_byte_position, &last_byte_position,
+                                &instance_length) ||
+      first_byte_position != read_offset_) {
+    ResetNetworkTransaction();
+    return ERR_CACHE_READ_FAILURE;
+  }
+
+  next_state_ = STATE_NETWORK_READ;
+  return OK;
+}
+
 int HttpCache::Transaction::DoCacheWriteData(int num_bytes) {
   next_state_ = STATE_CACHE_WRITE_DATA_COMPLETE;
   write_len_ = num_bytes;
@@ -1877,6 +2034,7 @@ int HttpCache::Transaction::DoCacheWriteDataComplete(int result) {
     int64 body_size = response_.headers->GetContentLength();
     if (body_size >= 0 && body_size <= current_size)
       done_reading_ = true;
+    cache_->OnStreamedDataWritten(entry_, current_size);
   }
 
   if (partial_) {
@@ -1892,6 +2050,8 @@ int HttpCache::Transaction::DoCacheWriteDataComplete(int result) {
     // have to keep the entry around to be flagged as truncated later on.
     if (done_reading_ || !entry_ || partial_ ||
         response_.headers->GetContentLength() <= 0) {
+      if (entry_)
+        cache_->DoneStreamingToEntry(entry_, true);
       DoneWritingToEntry(true);
     }
   }
@@ -2127,6 +2287,19 @@ int HttpCache::Transaction::BeginCacheValidation() {
     response_.async_revalidation_required = true;
   }
 
+  // Without an embedder to do it, the cache serves the stale entry and
+  // revalidates it itself. Range requests and truncated entries are left to
+  // the regular validation logic. So are requests with credentials: the
+  // background request has no URLRequest or NetworkDelegate, so it could
+  // neither answer an auth challenge nor update cookies.
+  bool validate_async = false;
+  if (!skip_validation && required_validation == VALIDATION_ASYNCHRONOUS &&
+      cache_->use_stale_while_revalidate() && request_->method == "GET" &&
+      !partial_ && !truncated_ && !RequestHasCredentials()) {
+    skip_validation = true;
+    validate_async = true;
+  }
+
   if (request_->method == "HEAD" &&
       (truncated_ || response_.headers->response_code() == 206)) {
     DCHECK(!partial_);
@@ -2156,7 +2329,12 @@ int HttpCache::Transaction::BeginCacheValidation() {
 
   if (skip_validation) {
     UpdateTransactionPattern(PATTERN_ENTRY_USED);
-    return SetupEntryForRead();
+    int rv = SetupEntryForRead();
+    if (validate_async)
+      cache_->PerformAsyncValidation(*request_, cache_key_);
+    return rv;
+  } else if (streaming_from_writer_) {
+    return WaitForWriter();
   } else {
     // Make the network request conditional, to see if we may reuse our cached
     // response.  If we cannot do so, then we just resort to a normal fetch.
@@ -2601,7 +2779,9 @@ int HttpCache::Transaction::SetupEntryForRead() {
       partial_.reset();
     }
   }
-  cache_->ConvertWriterToReader(entry_);
+  // A streaming reader is not the writer of the entry.
+  if (!streaming_from_writer_)
+    cache_->ConvertWriterToReader(entry_);
   mode_ = READ;
 
   if (request_->method == "HEAD")
@@ -2612,6 +2792,15 @@ int HttpCache::Transaction::SetupEntryForRead() {
   return OK;
 }
 
+int HttpCache::Transaction::WaitForWriter() {
+  cache_->DoneWithEntry(entry_, this, false);
+  entry_ = NULL;
+  streaming_from_writer_ = false;
+  wait_for_writer_ = true;
+  next_state_ = STATE_INIT_ENTRY;
+  return OK;
+}
+
 int HttpCache::Transaction::WriteToEntry(int index, int offset,
                                          IOBuffer* data, int data_len,
                                          const CompletionCallback& callback) {
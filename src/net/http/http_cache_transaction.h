@@ -116,6 +116,14 @@ class HttpCache::Transaction : public HttpTransaction {
 
   const CompletionCallback& io_callback() { return io_callback_; }
 
+  // Returns true if this transaction may use an entry whose body is still
+  // being written by another transaction, reading the body as it is stored.
+  bool CanStreamFromWriter() const;
+
+  // Called by the cache when the body this transaction is streaming grew or
+  // stopped growing.
+  void OnStreamedDataAvailable();
+
   const BoundNetLog& net_log() const;
 
   // Bypasses the cache lock whenever there is lock contention.
@@ -219,6 +227,8 @@ class HttpCache::Transaction : public HttpTransaction {
     STATE_NETWORK_READ_COMPLETE,
     STATE_CACHE_READ_DATA,
     STATE_CACHE_READ_DATA_COMPLETE,
+    STATE_RESUME_STREAMED_BODY,
+    STATE_RESUME_STREAMED_BODY_COMPLETE,
     STATE_CACHE_WRITE_DATA,
     STATE_CACHE_WRITE_DATA_COMPLETE,
     STATE_CACHE_WRITE_TRUNCATED_RESPONSE,
@@ -290,6 +300,8 @@ class HttpCache::Transaction : public HttpTransaction {
   int DoNetworkReadComplete(int result);
   int DoCacheReadData();
   int DoCacheReadDataComplete(int result);
+  int DoResumeStreamedBody();
+  int DoResumeStreamedBodyComplete(int result);
   int DoCacheWriteData(int num_bytes);
   int DoCacheWriteDataComplete(int result);
   int DoCacheWriteTruncatedResponse();
@@ -361,6 +373,15 @@ class HttpCache::Transaction : public HttpTransaction {
   // Setups the transaction for reading from the cache entry.
   int SetupEntryForRead();
 
+  // Called when a streaming reader finds that the entry has to be validated,
+  // which can't be done while the writer is active. Releases the entry and
+  // queues up behind the writer instead.
+  int WaitForWriter();
+
+  // Returns true if the request carries cookies or authentication data, which
+  // only the network stack underneath the URLRequest can keep up to date.
+  bool RequestHasCredentials() const;
+
   // Called to write data to the cache entry.  If the write fails, then the
   // cache entry is destroyed.  Future calls to this function will just do
   // nothing without side-effect.  Returns a network error code.
@@ -457,6 +478,9 @@ class HttpCache::Transaction : public HttpTransaction {
   bool couldnt_conditionalize_request_;
   bool bypass_lock_for_test_;  // A test is exercising the cache lock.
   bool fail_conditionalization_for_test_;  // Fail ConditionalizeRequest.
+  bool streaming_from_writer_;  // We read the body while it is written.
+  bool waiting_for_streamed_data_;  // We caught up with the writer.
+  bool wait_for_writer_;  // We can't stream from a writer.
   scoped_refptr<IOBuffer> read_buf_;
   int io_buf_len_;
   int read_offset_;
@@ -152,7 +152,9 @@ HttpConnection::HttpConnection(int id, scoped_ptr<StreamSocket> socket)
     : id_(id),
       socket_(socket.Pass()),
       read_buf_(new ReadIOBuffer()),
-      write_buf_(new QueuedWriteIOBuffer()) {
+      write_buf_(new QueuedWriteIOBuffer()),
+      read_paused_(false),
+      close_after_write_(false) {
 }
 
 HttpConnection::~HttpConnection() {
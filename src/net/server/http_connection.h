@@ -121,6 +121,17 @@ class HttpConnection {
   WebSocket* web_socket() const { return web_socket_.get(); }
   void SetWebSocket(scoped_ptr<WebSocket> web_socket);
 
+  // Whether reading is paused until pending writes drain.
+  bool read_paused() const { return read_paused_; }
+  void set_read_paused(bool read_paused) { read_paused_ = read_paused; }
+
+  // Whether the connection should be closed once pending writes drain, e.g.
+  // because the client sent "Connection: close".
+  bool close_after_write() const { return close_after_write_; }
+  void set_close_after_write(bool close_after_write) {
+    close_after_write_ = close_after_write;
+  }
+
  private:
   const int id_;
   const scoped_ptr<StreamSocket> socket_;
@@ -129,6 +140,9 @@ class HttpConnection {
 
   scoped_ptr<WebSocket> web_socket_;
 
+  bool read_paused_;
+  bool close_after_write_;
+
   DISALLOW_COPY_AND_ASSIGN(HttpConnection);
 };
 
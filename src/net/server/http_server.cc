@@ -11,6 +11,7 @@
 #include "base/single_thread_task_runner.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/sys_byteorder.h"
@@ -27,6 +28,18 @@
 
 namespace net {
 
+namespace {
+
+// Reading from a connection is paused while more than 1/kPauseReadingDivisor
+// of its write buffer limit is queued, and resumed once the queue drops to
+// 1/kResumeReadingDivisor of it. This keeps a client that pipelines requests
+// without reading the responses from growing the queue until the limit is
+// hit and responses start being dropped.
+const int kPauseReadingDivisor = 2;
+const int kResumeReadingDivisor = 4;
+
+}  // namespace
+
 HttpServer::HttpServer(scoped_ptr<ServerSocket> server_socket,
                        HttpServer::Delegate* delegate)
     : server_socket_(server_socket.Pass()),
@@ -203,11 +216,29 @@ int HttpServer::HandleReadResult(HttpConnection* connection, int rv) {
     return rv == 0 ? ERR_CONNECTION_CLOSED : rv;
   }
 
+  connection->read_buf()->DidRead(rv);
+  return ProcessReadBuffer(connection);
+}
+
+int HttpServer::ProcessReadBuffer(HttpConnection* connection) {
   HttpConnection::ReadIOBuffer* read_buf = connection->read_buf();
-  read_buf->DidRead(rv);
 
-  // Handles http requests or websocket messages.
-  while (read_buf->GetSize() > 0) {
+  // Handles http requests or websocket messages. Several requests may have
+  // been pipelined in a single read.
+  while (true) {
+    // Stops reading if the responses to earlier requests aren't being
+    // consumed, or if the client asked for the connection to be closed.
+    // Unprocessed data stays in |read_buf| until reading resumes.
+    if (connection->close_after_write() ||
+        connection->write_buf()->total_size() >
+            connection->write_buf()->max_buffer_size() /
+                kPauseReadingDivisor) {
+      connection->set_read_paused(true);
+      return ERR_IO_PENDING;
+    }
+    if (read_buf->GetSize() == 0)
+      break;
+
     if (connection->web_socket()) {
       std::string message;
       WebSocket::ParseResult result = connection->web_socket()->Read(&message);
@@ -267,6 +298,11 @@ int HttpServer::HandleReadResult(HttpConnection* connection, int rv) {
     }
 
     read_buf->DidConsume(pos);
+    // Connections are persistent by default in HTTP/1.1. If the client opted
+    // out, the connection is closed once the responses queued by then have
+    // been written.
+    if (request.HasHeaderValue("connection", "close"))
+      connection->set_close_after_write(true);
     delegate_->OnHttpRequest(connection->id(), request);
     if (HasClosedConnection(connection))
       return ERR_CONNECTION_CLOSED;
@@ -305,10 +341,42 @@ int HttpServer::HandleWriteResult(HttpConnection* connection, int rv) {
     return rv;
   }
 
-  connection->write_buf()->DidConsume(rv);
+  HttpConnection::QueuedWriteIOBuffer* write_buf = connection->write_buf();
+  write_buf->DidConsume(rv);
+  if (write_buf->IsEmpty() && connection->close_after_write()) {
+    // The response may still be sent in several pieces from the current call
+    // stack, so only close if nothing more has been queued by then.
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::Bind(&HttpServer::CloseIfWriteBufferEmpty,
+                              weak_ptr_factory_.GetWeakPtr(), connection->id()));
+  } else if (connection->read_paused() && !connection->close_after_write() &&
+             write_buf->total_size() <=
+                 write_buf->max_buffer_size() / kResumeReadingDivisor) {
+    // Resumes asynchronously so that delegate callbacks for buffered requests
+    // aren't run from within DoWriteLoop().
+    connection->set_read_paused(false);
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::Bind(&HttpServer::ResumeReading,
+                              weak_ptr_factory_.GetWeakPtr(), connection->id()));
+  }
   return OK;
 }
 
+void HttpServer::ResumeReading(int connection_id) {
+  HttpConnection* connection = FindConnection(connection_id);
+  if (!connection)
+    return;
+
+  if (ProcessReadBuffer(connection) == OK)
+    DoReadLoop(connection);
+}
+
+void HttpServer::CloseIfWriteBufferEmpty(int connection_id) {
+  HttpConnection* connection = FindConnection(connection_id);
+  if (connection && connection->write_buf()->IsEmpty())
+    Close(connection_id);
+}
+
 namespace {
 
 //
@@ -382,9 +450,11 @@ bool HttpServer::ParseHeaders(const char* data,
                               size_t* ppos) {
   size_t& pos = *ppos;
   int state = ST_METHOD;
-  std::string buffer;
+  // Every character consumed without a state transition belongs to the
+  // current token, so tokens are contiguous in |data| and are only copied
+  // once, when complete.
+  size_t token_begin = pos;
   std::string header_name;
-  std::string header_value;
   while (pos < data_len) {
     char ch = data[pos++];
     int input = charToInput(ch);
@@ -393,52 +463,43 @@ bool HttpServer::ParseHeaders(const char* data,
     bool transition = (next_state != state);
     HttpServerRequestInfo::HeadersMap::iterator it;
     if (transition) {
+      base::StringPiece token(data + token_begin, pos - 1 - token_begin);
+      base::StringPiece header_value;
       // Do any actions based on state transitions.
       switch (state) {
         case ST_METHOD:
-          info->method = buffer;
-          buffer.clear();
+          token.CopyToString(&info->method);
           break;
         case ST_URL:
-          info->path = buffer;
-          buffer.clear();
+          token.CopyToString(&info->path);
           break;
         case ST_PROTO:
           // TODO(mbelshe): Deal better with parsing protocol.
-          DCHECK(buffer == "HTTP/1.1");
-          buffer.clear();
+          DCHECK(token == "HTTP/1.1");
           break;
         case ST_NAME:
-          header_name = base::ToLowerASCII(buffer);
-          buffer.clear();
+          header_name = base::ToLowerASCII(token);
           break;
         case ST_VALUE:
-          base::TrimWhitespaceASCII(buffer, base::TRIM_LEADING, &header_value);
+          header_value = base::TrimWhitespaceASCII(token, base::TRIM_LEADING);
           it = info->headers.find(header_name);
           // See the second paragraph ("A sender MUST NOT generate multiple
           // header fields...") of tools.ietf.org/html/rfc7230#section-3.2.2.
           if (it == info->headers.end()) {
-            info->headers[header_name] = header_value;
+            header_value.CopyToString(&info->headers[header_name]);
           } else {
             it->second.append(",");
-            it->second.append(header_value);
+            header_value.AppendToString(&it->second);
           }
-          buffer.clear();
           break;
         case ST_SEPARATOR:
           break;
       }
       state = next_state;
+      token_begin = pos;
     } else {
       // Do any actions based on current state
       switch (state) {
-        case ST_METHOD:
-        case ST_URL:
-        case ST_PROTO:
-        case ST_VALUE:
-        case ST_NAME:
-          buffer.append(&ch, 1);
-          break;
         case ST_DONE:
           DCHECK(input == INPUT_LF);
           return true;
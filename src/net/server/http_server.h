@@ -89,14 +89,20 @@ class HttpServer {
   void DoReadLoop(HttpConnection* connection);
   void OnReadCompleted(int connection_id, int rv);
   int HandleReadResult(HttpConnection* connection, int rv);
+  // Dispatches the complete requests or messages in the read buffer of
+  // |connection|. Returns OK if more data should be read, ERR_IO_PENDING if
+  // reading is paused, or an error if the connection was closed.
+  int ProcessReadBuffer(HttpConnection* connection);
+  void ResumeReading(int connection_id);
 
   void DoWriteLoop(HttpConnection* connection);
   void OnWriteCompleted(int connection_id, int rv);
   int HandleWriteResult(HttpConnection* connection, int rv);
+  void CloseIfWriteBufferEmpty(int connection_id);
 
-  // Expects the raw data to be stored in recv_data_. If parsing is successful,
-  // will remove the data parsed from recv_data_, leaving only the unused
-  // recv data.
+  // Parses the request line and headers at the start of |data|. If parsing is
+  // successful, returns true and sets |pos| to the offset just past the
+  // headers. Only complete tokens are copied into |info|.
   bool ParseHeaders(const char* data,
                     size_t data_len,
                     HttpServerRequestInfo* info,
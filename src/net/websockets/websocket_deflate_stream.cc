@@ -33,6 +33,14 @@ namespace {
 const int kWindowBits = 15;
 const size_t kChunkSize = 4 * 1024;
 
+// Returns the zlib memory level to compress with when the window is
+// |window_bits| wide. The default pairs a 15 bit window with level 8; each
+// bit less halves the hash table with the window, so that a server asking
+// for a small window does not leave most of the compression state unused.
+int MemLevelForWindowBits(int window_bits) {
+  return std::max(1, WebSocketDeflater::kDefaultMemLevel - (15 - window_bits));
+}
+
 }  // namespace
 
 WebSocketDeflateStream::WebSocketDeflateStream(
@@ -54,7 +62,8 @@ WebSocketDeflateStream::WebSocketDeflateStream(
     DCHECK(params.has_client_max_window_bits_value());
     client_max_window_bits = params.client_max_window_bits();
   }
-  deflater_.Initialize(client_max_window_bits);
+  deflater_.Initialize(client_max_window_bits,
+                       MemLevelForWindowBits(client_max_window_bits));
   inflater_.Initialize(kWindowBits);
 }
 
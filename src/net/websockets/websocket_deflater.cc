@@ -7,41 +7,131 @@
 #include <string.h>
 #include <algorithm>
 #include <deque>
+#include <map>
+#include <utility>
 #include <vector>
 
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/synchronization/lock.h"
 #include "net/base/io_buffer.h"
 #include "third_party/zlib/zlib.h"
 
 namespace net {
 
+namespace {
+
+// Maximum number of idle contexts kept for each set of parameters. Contexts
+// released beyond this are freed.
+const size_t kMaxIdleContextsPerParameters = 32;
+
+scoped_ptr<z_stream> CreateContext(int window_bits, int mem_level) {
+  scoped_ptr<z_stream> stream(new z_stream);
+  memset(stream.get(), 0, sizeof(*stream));
+  int result = deflateInit2(stream.get(),
+                            Z_DEFAULT_COMPRESSION,
+                            Z_DEFLATED,
+                            -window_bits,  // Negative value for raw deflate
+                            mem_level,
+                            Z_DEFAULT_STRATEGY);
+  if (result != Z_OK) {
+    deflateEnd(stream.get());
+    return scoped_ptr<z_stream>();
+  }
+  return stream.Pass();
+}
+
+// Pool of reset deflate contexts for deflaters that do not take over context
+// between messages. Thread-safe, since deflaters live on whichever thread
+// owns their WebSocket.
+class DeflateContextPool {
+ public:
+  DeflateContextPool() {}
+
+  scoped_ptr<z_stream> Acquire(int window_bits, int mem_level) {
+    {
+      base::AutoLock lock(lock_);
+      std::vector<z_stream*>& idle =
+          idle_contexts_[std::make_pair(window_bits, mem_level)];
+      if (!idle.empty()) {
+        scoped_ptr<z_stream> stream(idle.back());
+        idle.pop_back();
+        return stream.Pass();
+      }
+    }
+    return CreateContext(window_bits, mem_level);
+  }
+
+  // |stream| must have been reset with deflateReset().
+  void Release(int window_bits, int mem_level, scoped_ptr<z_stream> stream) {
+    {
+      base::AutoLock lock(lock_);
+      std::vector<z_stream*>& idle =
+          idle_contexts_[std::make_pair(window_bits, mem_level)];
+      if (idle.size() < kMaxIdleContextsPerParameters) {
+        idle.push_back(stream.release());
+        return;
+      }
+    }
+    deflateEnd(stream.get());
+  }
+
+ private:
+  base::Lock lock_;
+  // Keyed by (window bits, memory level).
+  std::map<std::pair<int, int>, std::vector<z_stream*>> idle_contexts_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeflateContextPool);
+};
+
+base::LazyInstance<DeflateContextPool>::Leaky g_context_pool =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
 WebSocketDeflater::WebSocketDeflater(ContextTakeOverMode mode)
-    : mode_(mode), are_bytes_added_(false) {}
+    : mode_(mode),
+      window_bits_(0),
+      mem_level_(kDefaultMemLevel),
+      are_bytes_added_(false) {}
 
 WebSocketDeflater::~WebSocketDeflater() {
-  if (stream_) {
-    deflateEnd(stream_.get());
-    stream_.reset(NULL);
+  if (!stream_)
+    return;
+  if (mode_ == DO_NOT_TAKE_OVER_CONTEXT) {
+    deflateReset(stream_.get());
+    g_context_pool.Get().Release(window_bits_, mem_level_, stream_.Pass());
+    return;
   }
+  deflateEnd(stream_.get());
+  stream_.reset(NULL);
 }
 
 bool WebSocketDeflater::Initialize(int window_bits) {
-  DCHECK(!stream_);
-  stream_.reset(new z_stream);
+  return Initialize(window_bits, kDefaultMemLevel);
+}
 
+bool WebSocketDeflater::Initialize(int window_bits, int mem_level) {
+  DCHECK(!stream_);
   DCHECK_LE(8, window_bits);
   DCHECK_GE(15, window_bits);
-  memset(stream_.get(), 0, sizeof(*stream_));
-  int result = deflateInit2(stream_.get(),
-                            Z_DEFAULT_COMPRESSION,
-                            Z_DEFLATED,
-                            -window_bits,  // Negative value for raw deflate
-                            8,  // default mem level
-                            Z_DEFAULT_STRATEGY);
-  if (result != Z_OK) {
-    deflateEnd(stream_.get());
-    stream_.reset();
-    return false;
+  DCHECK_LE(1, mem_level);
+  DCHECK_GE(9, mem_level);
+  window_bits_ = window_bits;
+  mem_level_ = mem_level;
+
+  if (mode_ == DO_NOT_TAKE_OVER_CONTEXT) {
+    // Check that a context can be created, leaving it in the pool for the
+    // first message.
+    scoped_ptr<z_stream> stream =
+        g_context_pool.Get().Acquire(window_bits_, mem_level_);
+    if (!stream)
+      return false;
+    g_context_pool.Get().Release(window_bits_, mem_level_, stream.Pass());
+  } else {
+    stream_ = CreateContext(window_bits_, mem_level_);
+    if (!stream_)
+      return false;
   }
   const size_t kFixedBufferSize = 4096;
   fixed_buffer_.resize(kFixedBufferSize);
@@ -51,6 +141,8 @@ bool WebSocketDeflater::Initialize(int window_bits) {
 bool WebSocketDeflater::AddBytes(const char* data, size_t size) {
   if (!size)
     return true;
+  if (!EnsureContext())
+    return false;
 
   are_bytes_added_ = true;
   stream_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
@@ -70,6 +162,7 @@ bool WebSocketDeflater::Finish() {
     ResetContext();
     return true;
   }
+  DCHECK(stream_);
   stream_->next_in = NULL;
   stream_->avail_in = 0;
 
@@ -107,9 +200,21 @@ scoped_refptr<IOBufferWithSize> WebSocketDeflater::GetOutput(size_t size) {
   return result;
 }
 
+bool WebSocketDeflater::EnsureContext() {
+  if (stream_)
+    return true;
+  DCHECK_EQ(DO_NOT_TAKE_OVER_CONTEXT, mode_);
+  stream_ = g_context_pool.Get().Acquire(window_bits_, mem_level_);
+  return !!stream_;
+}
+
 void WebSocketDeflater::ResetContext() {
-  if (mode_ == DO_NOT_TAKE_OVER_CONTEXT)
+  if (mode_ == DO_NOT_TAKE_OVER_CONTEXT && stream_) {
+    // Nothing carries over to the next message, so give the context back
+    // until then.
     deflateReset(stream_.get());
+    g_context_pool.Get().Release(window_bits_, mem_level_, stream_.Pass());
+  }
   are_bytes_added_ = false;
 }
 
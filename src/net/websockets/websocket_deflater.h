@@ -30,14 +30,25 @@ class NET_EXPORT_PRIVATE WebSocketDeflater {
     NUM_CONTEXT_TAKEOVER_MODE_TYPES,
   };
 
+  // The zlib memory level used by Initialize(int). See deflateInit2().
+  static const int kDefaultMemLevel = 8;
+
   explicit WebSocketDeflater(ContextTakeOverMode mode);
   ~WebSocketDeflater();
 
   // Returns true if there is no error and false otherwise.
-  // This function must be called exactly once before calling any of
+  // One of these functions must be called exactly once before calling any of
   // following methods.
   // |window_bits| must be between 8 and 15 (both inclusive).
+  // |mem_level| must be between 1 and 9 (both inclusive). Lower levels make
+  // each compression context smaller, at some cost in speed and ratio.
+  //
+  // In DO_NOT_TAKE_OVER_CONTEXT mode no state survives between messages, so
+  // the compression context is taken from a process-wide pool (shared by
+  // deflaters with the same parameters) when a message starts and returned
+  // when it ends. Idle connections then hold no zlib state.
   bool Initialize(int window_bits);
+  bool Initialize(int window_bits, int mem_level);
 
   // Adds bytes to |stream_|.
   // Returns true if there is no error and false otherwise.
@@ -61,11 +72,16 @@ class NET_EXPORT_PRIVATE WebSocketDeflater {
   size_t CurrentOutputSize() const { return buffer_.size(); }
 
  private:
+  // Takes a context from the pool if |stream_| is not set. Only needed in
+  // DO_NOT_TAKE_OVER_CONTEXT mode. Returns false on failure.
+  bool EnsureContext();
   void ResetContext();
   int Deflate(int flush);
 
   scoped_ptr<z_stream_s> stream_;
   ContextTakeOverMode mode_;
+  int window_bits_;
+  int mem_level_;
   std::deque<char> buffer_;
   std::vector<char> fixed_buffer_;
   // true if bytes were added after last Finish().
@@ -13,6 +13,10 @@
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 
+#if defined(COMPILER_MSVC) && defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+
 namespace net {
 
 namespace {
@@ -21,10 +25,15 @@ namespace {
 // architectures where we know it works, otherwise gcc will attempt to emulate
 // the vector ops, which is unlikely to be efficient.
 // TODO(ricea): Add ARCH_CPU_ARM_FAMILY when arm_neon=1 becomes the default.
+// MSVC has no vector extensions, so SSE2 intrinsics are used there instead.
 #if defined(COMPILER_GCC) && defined(ARCH_CPU_X86_FAMILY) && !defined(OS_NACL)
 
 using PackedMaskType = uint32_t __attribute__((vector_size(16)));
 
+#elif defined(COMPILER_MSVC) && defined(ARCH_CPU_X86_FAMILY)
+
+using PackedMaskType = __m128i;
+
 #else
 
 using PackedMaskType = size_t;
@@ -32,6 +41,24 @@ using PackedMaskType = size_t;
 #endif  // defined(COMPILER_GCC) && defined(ARCH_CPU_X86_FAMILY) &&
         // !defined(OS_NACL)
 
+// XORs the sizeof(PackedMaskType) bytes at |data|, which must be suitably
+// aligned, with |packed_mask_key| in place.
+inline void MaskPackedPayload(const PackedMaskType& packed_mask_key,
+                              char* data) {
+#if defined(COMPILER_MSVC) && defined(ARCH_CPU_X86_FAMILY)
+  __m128i* packed = reinterpret_cast<__m128i*>(data);
+  _mm_store_si128(packed,
+                  _mm_xor_si128(_mm_load_si128(packed), packed_mask_key));
+#else
+  // This is not quite standard-compliant C++. However, the standard-compliant
+  // equivalent (using memcpy()) compiles to slower code using g++. In
+  // practice, this will work for the compilers and architectures currently
+  // supported by Chromium, and the tests are extremely unlikely to pass if a
+  // future compiler/architecture breaks it.
+  *reinterpret_cast<PackedMaskType*>(data) ^= packed_mask_key;
+#endif
+}
+
 const uint8_t kFinalBit = 0x80;
 const uint8_t kReserved1Bit = 0x40;
 const uint8_t kReserved2Bit = 0x20;
@@ -234,12 +261,7 @@ void MaskWebSocketFramePayload(const WebSocketMaskingKey& masking_key,
   // The main loop.
   for (char* merged = aligned_begin; merged != aligned_end;
        merged += kPackedMaskKeySize) {
-    // This is not quite standard-compliant C++. However, the standard-compliant
-    // equivalent (using memcpy()) compiles to slower code using g++. In
-    // practice, this will work for the compilers and architectures currently
-    // supported by Chromium, and the tests are extremely unlikely to pass if a
-    // future compiler/architecture breaks it.
-    *reinterpret_cast<PackedMaskType*>(merged) ^= packed_mask_key;
+    MaskPackedPayload(packed_mask_key, merged);
   }
 
   MaskWebSocketFramePayloadByBytes(
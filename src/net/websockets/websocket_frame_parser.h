@@ -49,28 +49,31 @@ class NET_EXPORT WebSocketFrameParser {
   WebSocketError websocket_error() const { return websocket_error_; }
 
  private:
-  // Tries to decode a frame header from |current_read_pos_|.
-  // If successful, this function updates |current_read_pos_|,
-  // |current_frame_header_|, and |masking_key_| (if available).
-  // This function may set |failed_| to true if it observes a corrupt frame.
-  // If there is not enough data in the remaining buffer to parse a frame
-  // header, this function returns without doing anything.
-  void DecodeFrameHeader();
-
-  // Decodes frame payload and creates a WebSocketFrameChunk object.
-  // This function updates |current_read_pos_| and |frame_offset_| after
-  // parsing. This function returns a frame object even if no payload data is
-  // available at this moment, so the receiver could make use of frame header
-  // information. If the end of frame is reached, this function clears
-  // |current_frame_header_|, |frame_offset_| and |masking_key_|.
-  scoped_ptr<WebSocketFrameChunk> DecodeFramePayload(bool first_chunk);
-
-  // Internal buffer to store the data to parse.
+  // Tries to decode a frame header from the |length| bytes at |data|.
+  // If successful, this function updates |current_frame_header_| and
+  // |masking_key_| (if available), and returns the number of bytes consumed.
+  // This function may set |websocket_error_| if it observes a corrupt frame.
+  // If there is not enough data to parse a frame header, this function
+  // returns 0 without doing anything.
+  size_t DecodeFrameHeader(const char* data, size_t length);
+
+  // Decodes frame payload from the |length| bytes at |data| and creates a
+  // WebSocketFrameChunk object. The payload is unmasked as it is copied out
+  // of |data|. This function advances |*pos| by the number of bytes consumed
+  // and updates |frame_offset_|. This function returns a frame object even if
+  // no payload data is available at this moment, so the receiver could make
+  // use of frame header information. If the end of frame is reached, this
+  // function clears |current_frame_header_|, |frame_offset_| and
+  // |masking_key_|.
+  scoped_ptr<WebSocketFrameChunk> DecodeFramePayload(bool first_chunk,
+                                                     const char* data,
+                                                     size_t length,
+                                                     size_t* pos);
+
+  // Holds a frame header that was split across calls to Decode(). The rest of
+  // the input is parsed in place without being copied here.
   std::vector<char> buffer_;
 
-  // Position in |buffer_| where the next round of parsing starts.
-  size_t current_read_pos_;
-
   // Frame header and masking key of the current frame.
   // |masking_key_| is filled with zeros if the current frame is not masked.
   scoped_ptr<WebSocketFrameHeader> current_frame_header_;
@@ -10,6 +10,7 @@
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/message_loop/message_loop.h"
+#include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/string_util.h"
 #include "base/sys_info.h"
@@ -113,6 +114,14 @@ Compositor::Compositor(ui::ContextFactory* context_factory,
 #if defined(OS_WIN)
   settings.renderer_settings.finish_rendering_on_resize = true;
 #endif
+  // Only used when the output surface is software; the bands are drawn on the
+  // context factory's raster workers and on this thread.
+  if (command_line->HasSwitch(switches::kUIEnableParallelSoftwareCompositing) ||
+      base::FieldTrialList::FindFullName("ParallelSoftwareCompositing") ==
+          "Enabled") {
+    settings.renderer_settings.software_compositor_band_count =
+        std::min(base::SysInfo::NumberOfProcessors(), 4);
+  }
 
   // These flags should be mirrored by renderer versions in content/renderer/.
   settings.initial_debug_state.show_debug_borders =
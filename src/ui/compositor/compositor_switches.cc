@@ -21,6 +21,10 @@ const char kUIDisablePartialSwap[] = "ui-disable-partial-swap";
 const char kUIEnableCompositorAnimationTimelines[] =
     "ui-enable-compositor-animation-timelines";
 
+// Draw software composited frames in horizontal bands on several threads.
+const char kUIEnableParallelSoftwareCompositing[] =
+    "ui-enable-parallel-software-compositing";
+
 const char kUIEnableRGBA4444Textures[] = "ui-enable-rgba-4444-textures";
 
 const char kUIEnableZeroCopy[] = "ui-enable-zero-copy";
@@ -71,6 +71,37 @@ const int kTempHostBufferLen = 1024;
 typedef RawCanonOutputT<char, kTempHostBufferLen> StackBuffer;
 typedef RawCanonOutputT<base::char16, kTempHostBufferLen> StackBufferW;
 
+// Appends the run of characters of |host| starting at |begin| that are
+// already canonical, stopping at |end|, and returns the number of characters
+// appended. Only narrow-to-narrow canonicalization takes this fast path; other
+// combinations are handled a character at a time.
+template<typename INCHAR, typename OUTCHAR>
+int AppendCanonicalHostRun(const INCHAR* host,
+                           int begin,
+                           int end,
+                           CanonOutputT<OUTCHAR>* output) {
+  return 0;
+}
+
+int AppendCanonicalHostRun(const char* host,
+                           int begin,
+                           int end,
+                           CanonOutput* output) {
+  int i = begin;
+  while (i < end) {
+    i = FindEndOfAlphanumericRun(host, i, end, false);
+    if (i == end)
+      break;
+    // Characters such as '.' canonicalize to themselves, too.
+    unsigned char ch = static_cast<unsigned char>(host[i]);
+    if (ch == 0 || ch >= 0x80 || kHostCharLookup[ch] != ch)
+      break;
+    i++;
+  }
+  output->Append(&host[begin], i - begin);
+  return i - begin;
+}
+
 // Scans a host name and fills in the output flags according to what we find.
 // |has_non_ascii| will be true if there are any non-7-bit characters, and
 // |has_escaped| will be true if there is a percent sign.
@@ -120,6 +151,10 @@ bool DoSimpleHost(const INCHAR* host,
 
   bool success = true;
   for (int i = 0; i < host_len; ++i) {
+    i += AppendCanonicalHostRun(host, i, host_len, output);
+    if (i == host_len)
+      break;
+
     unsigned int source = host[i];
     if (source == '%') {
       // Unescape first, if possible.
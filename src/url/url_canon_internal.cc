@@ -11,6 +11,11 @@
 #include <string>
 
 #include "base/strings/utf_string_conversion_utils.h"
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <emmintrin.h>
+#endif
 
 namespace url {
 
@@ -234,6 +239,46 @@ const char kCharToHexLookup[8] = {
 
 const base::char16 kUnicodeReplacementCharacter = 0xfffd;
 
+int FindEndOfAlphanumericRun(const char* spec, int begin, int end,
+                             bool allow_upper) {
+  int i = begin;
+#if defined(ARCH_CPU_X86_FAMILY)
+  // The signed comparisons below treat characters >= 0x80 as negative, so
+  // they never fall in any of the accepted ranges.
+  const __m128i before_a = _mm_set1_epi8('a' - 1);
+  const __m128i after_z = _mm_set1_epi8('z' + 1);
+  const __m128i before_0 = _mm_set1_epi8('0' - 1);
+  const __m128i after_9 = _mm_set1_epi8('9' + 1);
+  const __m128i dash = _mm_set1_epi8('-');
+  const __m128i underscore = _mm_set1_epi8('_');
+  // OR-ing in 0x20 maps 'A'-'Z' (and nothing else) onto 'a'-'z'.
+  const __m128i case_bit = _mm_set1_epi8(allow_upper ? 0x20 : 0);
+  for (; i + 16 <= end; i += 16) {
+    __m128i chars =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&spec[i]));
+    __m128i folded = _mm_or_si128(chars, case_bit);
+    __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(folded, before_a),
+                                   _mm_cmplt_epi8(folded, after_z));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(chars, before_0),
+                                  _mm_cmplt_epi8(chars, after_9));
+    __m128i punct = _mm_or_si128(_mm_cmpeq_epi8(chars, dash),
+                                 _mm_cmpeq_epi8(chars, underscore));
+    __m128i plain = _mm_or_si128(_mm_or_si128(letter, digit), punct);
+    if (_mm_movemask_epi8(plain) != 0xffff)
+      break;  // The scalar loop below finds the exact position.
+  }
+#endif
+  for (; i < end; i++) {
+    unsigned char ch = static_cast<unsigned char>(spec[i]);
+    if (allow_upper && ch >= 'A' && ch <= 'Z')
+      continue;
+    if ((ch < 'a' || ch > 'z') && (ch < '0' || ch > '9') && ch != '-' &&
+        ch != '_')
+      break;
+  }
+  return i;
+}
+
 void AppendStringOfType(const char* source, int length,
                         SharedCharTypes type,
                         CanonOutput* output) {
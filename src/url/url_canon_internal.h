@@ -72,6 +72,18 @@ inline bool IsComponentChar(unsigned char c) {
   return IsCharOfType(c, CHAR_COMPONENT);
 }
 
+// Returns the index of the first character in |spec| between |begin| and
+// |end| (non-inclusive) that is not an ASCII lower-case letter, digit, '-' or
+// '_', or |end| if there is none. Upper-case letters are also accepted when
+// |allow_upper| is set; host names fold case so they cannot.
+//
+// None of these characters need escaping or other special handling in the
+// components that use this, so callers use it to find runs of input they can
+// append to the output in bulk rather than a character at a time. On x86 the
+// input is tested 16 characters at a time.
+int FindEndOfAlphanumericRun(const char* spec, int begin, int end,
+                             bool allow_upper);
+
 // Appends the given string to the output, escaping characters that do not
 // match the given |type| in SharedCharTypes.
 void AppendStringOfType(const char* source, int length,
@@ -75,6 +75,33 @@ const unsigned char kPathCharLookup[0x100] = {
      ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,
      ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE,  ESCAPE};
 
+// Appends the run of characters of |spec| starting at |begin| that can be
+// copied to the output unmodified, that is, ASCII characters without the
+// SPECIAL flag, stopping at |end|. Returns the number of characters copied.
+// Wide input is always handled a character at a time by the caller.
+int AppendPlainPathRun(const char* spec,
+                       int begin,
+                       int end,
+                       CanonOutput* output) {
+  int i = begin;
+  while (i < end) {
+    i = FindEndOfAlphanumericRun(spec, i, end, true);
+    if (i == end ||
+        (kPathCharLookup[static_cast<unsigned char>(spec[i])] & SPECIAL))
+      break;
+    i++;  // Other non-special characters, such as '/', are also copied.
+  }
+  output->Append(&spec[begin], i - begin);
+  return i - begin;
+}
+
+int AppendPlainPathRun(const base::char16* spec,
+                       int begin,
+                       int end,
+                       CanonOutput* output) {
+  return 0;
+}
+
 enum DotDisposition {
   // The given dot is just part of a filename and is not special.
   NOT_A_DIRECTORY,
@@ -259,6 +286,12 @@ bool DoPartialPath(const CHAR* spec,
 
   bool success = true;
   for (int i = path.begin; i < end; i++) {
+    // Copy characters that need no canonicalization in bulk. This only
+    // stops at characters needing the handling below.
+    i += AppendPlainPathRun(spec, i, end, output);
+    if (i == end)
+      break;
+
     UCHAR uch = static_cast<UCHAR>(spec[i]);
     if (sizeof(CHAR) > 1 && uch >= 0x80) {
       // We only need to test wide input for having non-ASCII characters. For
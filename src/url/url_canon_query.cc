@@ -51,6 +51,31 @@ bool IsAllASCII(const CHAR* spec, const Component& query) {
   return true;
 }
 
+// Appends the run of characters of |source| starting at |begin| that do not
+// need escaping, stopping at |end|, and returns the number of characters
+// appended. Wide input is handled a character at a time by the caller.
+int AppendQueryCharRun(const char* source,
+                       int begin,
+                       int end,
+                       CanonOutput* output) {
+  int i = begin;
+  while (i < end) {
+    i = FindEndOfAlphanumericRun(source, i, end, true);
+    if (i == end || !IsQueryChar(static_cast<unsigned char>(source[i])))
+      break;
+    i++;
+  }
+  output->Append(&source[begin], i - begin);
+  return i - begin;
+}
+
+int AppendQueryCharRun(const base::char16* source,
+                       int begin,
+                       int end,
+                       CanonOutput* output) {
+  return 0;
+}
+
 // Appends the given string to the output, escaping characters that do not
 // match the given |type| in SharedCharTypes. This version will accept 8 or 16
 // bit characters, but assumes that they have only 7-bit values. It also assumes
@@ -59,6 +84,10 @@ template<typename CHAR>
 void AppendRaw8BitQueryString(const CHAR* source, int length,
                               CanonOutput* output) {
   for (int i = 0; i < length; i++) {
+    i += AppendQueryCharRun(source, i, length, output);
+    if (i == length)
+      break;
+
     if (!IsQueryChar(static_cast<unsigned char>(source[i])))
       AppendEscapedChar(static_cast<unsigned char>(source[i]), output);
     else  // Doesn't need escaping.